@@ -56,6 +56,36 @@ public:
 };
 
 
+// The corpus with "\r\n" line breaks
+class CrlfFixture : public TextFixture
+{
+public:
+  virtual void SetUp()
+  {
+    TextFixture::SetUp();
+    text = nonstd::string_utils::replace(text, "\n", "\r\n");
+  }
+};
+
+
+#ifdef NONSTD_STRING_UTILS_MMAP
+class MappedFixture : public hayai::Fixture
+{
+public:
+  virtual void SetUp()
+  {
+    file = nonstd::string_utils::mapped_file{"text/OEB-2016.1-US.txt", true};
+  }
+  virtual void TearDown()
+  {
+    file = nonstd::string_utils::mapped_file{};
+  }
+
+  nonstd::string_utils::mapped_file file;
+};
+#endif
+
+
 const char* csv_full = "988862858,689472910,562017896,668351927,222982619,758628814,764514667,"
     "849121270,60621066,584657136,152583039,572948523,777880448,794166280,813407618,293198796,"
     "549147080,987538342,878439310,880215256,826283467,64067515,931266377,426142721,760949057,"
@@ -89,6 +119,22 @@ const char* csv_constw = "116112,117178,129932,138393,151968,155886,163385,16717
     "788282,796438,798506,801473,808019,810449,813513,817826,818428,826048,879258,879500,"
     "881416,898259,928830,958558,962443,994418,997562";
 
+const char* csv_float = "-524.070746,0.5442292252959519,3.700e+09,60392.00,251.440608,"
+    "0.06552885923981311,1.317e+08,83746.91,-481.291971,0.23433096104669637,9.956e+09,47026.35,"
+    "672.922903,0.47635320869933495,6.391e+09,15061.64,269.721317,0.8680453071432968,5.232e+09,"
+    "74125.19,342.822951,0.0640314382269973,7.582e+09,59109.96,-397.464681,0.031011751469749993,"
+    "8.655e+09,47274.91,437.647848,0.8788128002554817,7.141e+09,92109.87,-210.073192,"
+    "0.8009087709852283,4.446e+09,93558.67,757.733321,0.09745430973087721,1.360e+09,21698.69,"
+    "930.960278,0.4361618666274293,6.266e+09,30102.62,14.485968,0.38586625884490255,3.509e+09,"
+    "58507.41,168.503586,0.9042017708477751,6.820e+09,92894.56,712.801133,0.9909896448688151,"
+    "6.713e+09,16309.96,721.275066,0.9646329473090614,9.047e+09,56910.75,427.634040,"
+    "0.2111249836755983,8.316e+09,57353.24,-430.085076,0.06346057714522935,8.539e+09,98980.60,"
+    "-822.963814,0.8005953212575019,4.105e+09,15076.54,-412.217506,0.7687918872773446,8.728e+09,"
+    "4419.01,229.065057,0.0449402434960362,7.184e+09,33095.41,761.810614,0.9806357568433396,"
+    "5.054e+09,99850.89,-380.659893,0.0769707047054119,5.998e+09,3137.78,-605.230287,"
+    "0.4079361356169908,6.105e+09,15619.90,-915.128351,0.8677790339277224,3.138e+09,95865.94,"
+    "793.319283,0.3777892394121827,4.604e+09,52007.30";
+
 const char* leper = R"(On one occasion Jesus was staying in a town, when he saw a man who was
 covered with leprosy. When the leper saw Jesus, he threw himself on his face and
 implored his help, "Master, if only you are willing, you are able to make me
@@ -127,6 +173,128 @@ BENCHMARK(string, split, 100, 10000)
 }
 
 
+BENCHMARK(string, split_at_char, 100, 10000)
+{
+  auto v = nonstd::string_utils::split(csv_constw, ',');
+  for (auto sv : v) {
+    int i;
+    escape(&i);
+    i = nonstd::string_utils::as_int(sv);
+    clobber();
+  }
+}
+
+
+BENCHMARK_F(RandomFixture, split_at_substring, 100, 100000)
+{
+  auto v = nonstd::string_utils::detail::split_keep_empty<std::string_view>(s, ",");
+  escape(v.data());
+}
+
+
+BENCHMARK_F(RandomFixture, split_at_char, 100, 100000)
+{
+  auto v = nonstd::string_utils::split(s, ',');
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_reuse, 100, 10000)
+{
+  static std::vector<std::string_view> v;
+  nonstd::string_utils::split(csv_constw, ",", v);
+  for (auto sv : v) {
+    int i;
+    escape(&i);
+    i = nonstd::string_utils::as_int(sv);
+    clobber();
+  }
+}
+
+
+BENCHMARK(string, split_for_each, 100, 10000)
+{
+  nonstd::string_utils::split_for_each(csv_constw, ",", [](std::string_view sv) {
+    int i;
+    escape(&i);
+    i = nonstd::string_utils::as_int(sv);
+    clobber();
+  });
+}
+
+
+BENCHMARK(string, split_chars_for_each, 100, 10000)
+{
+  nonstd::string_utils::split_chars_for_each(csv_constw, 6, 1, [](std::string_view sv) {
+    int i;
+    escape(&i);
+    i = nonstd::string_utils::as_int(sv);
+    clobber();
+  });
+}
+
+
+BENCHMARK(string, parse_delimited, 100, 10000)
+{
+  int values[128];
+  escape(values);
+  nonstd::string_utils::parse_delimited<int>(csv_constw, ',', values);
+  clobber();
+}
+
+
+const char* csv_quoted = "id,name,amount,comment\n"
+    "1,\"Smith, John\",12.50,\"said \"\"hi\"\"\"\n"
+    "2,\"Doe, Jane\",7.25,plain\n"
+    "3,Roe,100.00,\"multi\nline\"\n";
+
+
+BENCHMARK(string, csv_reader, 100, 100000)
+{
+  static std::vector<nonstd::string_utils::csv_field> fields;
+  nonstd::string_utils::csv_reader reader{csv_quoted};
+  std::size_t size = 0;
+  while (reader.read_record(fields)) {
+    for (const auto& field : fields)
+      size += field.raw.size();
+  }
+  escape(&size);
+}
+
+
+BENCHMARK(string, split_as_double, 100, 10000)
+{
+  nonstd::string_utils::split_for_each(csv_float, ",", [](std::string_view sv) {
+    double d;
+    escape(&d);
+    d = nonstd::string_utils::as_double(sv);
+    clobber();
+  });
+}
+
+
+BENCHMARK(string, parse_delimited_double, 100, 10000)
+{
+  double values[128];
+  escape(values);
+  auto result = nonstd::string_utils::parse_delimited<double>(csv_float, ',', values);
+  if (!result)
+    std::abort();
+  clobber();
+}
+
+
+BENCHMARK(string, split_chars_as_uint32_fixed, 100, 10000)
+{
+  nonstd::string_utils::split_chars_for_each(csv_constw, 6, 1, [](std::string_view sv) {
+    std::uint32_t i;
+    escape(&i);
+    i = nonstd::string_utils::as_uint32_fixed<6>(sv);
+    clobber();
+  });
+}
+
+
 BENCHMARK(string, split_copy, 100, 10000)
 {
   auto v = nonstd::string_utils::split_copy(csv_constw, ",");
@@ -139,6 +307,119 @@ BENCHMARK(string, split_copy, 100, 10000)
 }
 
 
+BENCHMARK(string, split_copy_only, 100, 10000)
+{
+  auto v = nonstd::string_utils::split_copy(csv_constw, ",");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_into_column, 100, 10000)
+{
+  auto column = nonstd::string_utils::split_into_column(csv_constw, ",");
+  escape(&column);
+}
+
+
+BENCHMARK(string, split_into_column_reused, 100, 10000)
+{
+  static nonstd::string_utils::string_column column;
+  nonstd::string_utils::split_into_column(csv_constw, ",", column);
+  escape(&column);
+}
+
+
+BENCHMARK(string, split_copy_arena, 100, 10000)
+{
+  nonstd::string_utils::string_arena arena;
+  auto v = nonstd::string_utils::split_copy(csv_constw, ",", arena);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, split_copy_words, 5, 100)
+{
+  auto v = nonstd::string_utils::split_copy(text, " ");
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, split_copy_words_arena, 5, 100)
+{
+  nonstd::string_utils::string_arena arena;
+  auto v = nonstd::string_utils::split_copy(text, " ", arena);
+  escape(v.data());
+}
+
+
+const char* parts_64 = "0:1:2:3:4:5:6:7:8:9:10:11:12:13:14:15:16:17:18:19:20:21:22:23:24:25:26:"
+    "27:28:29:30:31:32:33:34:35:36:37:38:39:40:41:42:43:44:45:46:47:48:49:50:51:52:53:"
+    "54:55:56:57:58:59:60:61:62:63";
+
+
+BENCHMARK(string, split_2_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split("example.com:8080", ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_small_2_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split_small<8>("example.com:8080", ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_4_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split("usr:local:share:doc", ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_small_4_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split_small<8>("usr:local:share:doc", ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_8_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split("a:bb:c:dd:e:ff:g:hh", ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_small_8_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split_small<8>("a:bb:c:dd:e:ff:g:hh", ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_64_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split(parts_64, ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_small_64_parts, 100, 100000)
+{
+  auto v = nonstd::string_utils::split_small<8>(parts_64, ":");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_constant_token, 100, 10000)
+{
+  auto v = nonstd::string_utils::split<','>(csv_constw);
+  escape(v.data());
+}
+
+
 BENCHMARK(string, split_chars, 100, 10000)
 {
   auto v = nonstd::string_utils::split_chars(csv_constw, 6, 1);
@@ -151,21 +432,71 @@ BENCHMARK(string, split_chars, 100, 10000)
 }
 
 
-/*
+// replace as it was before match positions were batched, to compare against
+static std::string replace_positions(std::string_view sv, std::string_view search_token,
+    std::string_view replace_token)
+{
+  std::vector<std::size_t> positions;
+  for (auto p = sv.find(search_token); p != std::string_view::npos;
+      p = sv.find(search_token, p + search_token.size())) {
+    positions.push_back(p);
+  }
+  if (positions.empty())
+    return std::string{sv};
+
+  std::string result;
+  result.resize(sv.size() - search_token.size() * positions.size() +
+      replace_token.size() * positions.size());
+  auto result_it = std::begin(result);
+  auto source_it = std::begin(sv);
+  for (auto p : positions) {
+    result_it = std::copy(source_it, std::begin(sv) + p, result_it);
+    result_it = std::copy(std::begin(replace_token), std::end(replace_token), result_it);
+    source_it = std::begin(sv) + p + search_token.size();
+  }
+  if (result_it != std::end(result)) {
+    std::copy(source_it, std::end(sv), result_it);
+  }
+
+  return result;
+}
+
+
 BENCHMARK_F(TextFixture, replace, 5, 1000)
 {
   auto s = nonstd::string_utils::detail::replace(text, "Jesus", "Logos");
+  escape(s.data());
+}
+
+
+BENCHMARK_F(TextFixture, replace_positions, 5, 1000)
+{
+  auto s = replace_positions(text, "Jesus", "Logos");
+  escape(s.data());
 }
 
 
 BENCHMARK_F(TextFixture, replace_inplace, 5, 1000)
 {
   auto s = nonstd::string_utils::detail::replace_inplace(text, "Jesus", "Logos");
+  escape(s.data());
+}
+
+
+BENCHMARK_F(TextFixture, replace_dense, 5, 100)
+{
+  auto s = nonstd::string_utils::replace(text, "e", "E!");
+  escape(s.data());
+}
+
+
+BENCHMARK_F(TextFixture, replace_dense_positions, 5, 100)
+{
+  auto s = replace_positions(text, "e", "E!");
+  escape(s.data());
 }
-*/
 
 
-/*
 BENCHMARK(string, replace, 100, 100000)
 {
   auto s = std::string{"The quick brown fox jumps over the lazy brown dog "
@@ -176,12 +507,12 @@ BENCHMARK(string, replace, 100, 100000)
 }
 
 
-BENCHMARK(string, replace2, 100, 100000)
+BENCHMARK(string, replace_positions, 100, 100000)
 {
   auto s = std::string{"The quick brown fox jumps over the lazy brown dog "
       "and eats a brown apple from a brown tree under a brown sky"};
   escape(&s);
-  s = nonstd::string_utils::detail::replace2(s, "brown", "blueorangeredgreen");
+  s = replace_positions(s, "brown", "blueorangeredgreen");
   clobber();
 }
 
@@ -196,18 +527,291 @@ BENCHMARK(string, replace_inplace, 100, 10000)
 }
 
 
-BENCHMARK(string, split_for_each, 100, 100000)
+const char* long_token = "And Jesus said unto him, See thou tell no man";
+
+
+BENCHMARK_F(TextFixture, find_long_token, 10, 100)
 {
-  nonstd::string_utils::ascii::split_for_each(csv_constw, 6, 1);
+  std::string_view sv = text;
+  std::size_t count = 0;
+  for (auto i = sv.find(long_token); i != std::string_view::npos;
+      i = sv.find(long_token, i + 1)) {
+    count++;
+  }
+  escape(&count);
 }
 
 
-BENCHMARK_F(RandomFixture, split_at_char, 100, 100000)
+BENCHMARK_F(TextFixture, searcher_long_token, 10, 100)
+{
+  static const nonstd::string_utils::searcher s{long_token};
+  std::size_t count = 0;
+  for (auto i = s.find(text); i != std::string_view::npos; i = s.find(text, i + 1))
+    count++;
+  escape(&count);
+}
+
+
+BENCHMARK_F(TextFixture, split_searcher, 10, 100)
+{
+  static const nonstd::string_utils::searcher s{"\n\n"};
+  auto v = nonstd::string_utils::split(text, s);
+  escape(v.data());
+}
+
+
+const char* header_keys[] = {"Content-Type", "Accept-Encoding", "X-Forwarded-For",
+    "User-Agent", "Cache-Control", "Authorization", "Content-Length", "Connection"};
+
+
+BENCHMARK(string, as_lower_header_keys, 100, 100000)
+{
+  char buffer[64];
+  for (auto key : header_keys) {
+    auto lower = nonstd::string_utils::ascii::as_lower(key, buffer);
+    escape(&lower);
+  }
+  clobber();
+}
+
+
+BENCHMARK_F(TextFixture, to_upper, 10, 100)
+{
+  nonstd::string_utils::ascii::to_upper(text);
+  escape(text.data());
+}
+
+
+BENCHMARK(string, replace_chained_escape, 100, 10000)
+{
+  auto s = std::string{"<a href=\"/search?q=fox&lang=en\">The \"quick\" brown fox</a> & "
+      "<b>the lazy dog</b>"};
+  escape(&s);
+  s = nonstd::string_utils::replace(s, "&", "&amp;");
+  s = nonstd::string_utils::replace(s, "<", "&lt;");
+  s = nonstd::string_utils::replace(s, ">", "&gt;");
+  s = nonstd::string_utils::replace(s, "\"", "&quot;");
+  clobber();
+}
+
+
+BENCHMARK(string, replace_all_escape, 100, 10000)
+{
+  static const nonstd::string_utils::multi_replacer html{{"&", "&amp;"}, {"<", "&lt;"},
+      {">", "&gt;"}, {"\"", "&quot;"}};
+  auto s = std::string{"<a href=\"/search?q=fox&lang=en\">The \"quick\" brown fox</a> & "
+      "<b>the lazy dog</b>"};
+  escape(&s);
+  s = html.replace(s);
+  clobber();
+}
+
+
+BENCHMARK_F(TextFixture, replace_all, 5, 100)
+{
+  static const nonstd::string_utils::multi_replacer names{{"Jesus", "Logos"},
+      {"Moses", "Moshe"}, {"Israel", "Yisrael"}, {"LORD", "Lord"}};
+  auto s = names.replace(text);
+  escape(s.data());
+}
+
+
+BENCHMARK_F(TextFixture, replace_in, 5, 100)
+{
+  auto s = text;
+  nonstd::string_utils::replace_in(s, "Jesus", "Jesus Christ");
+  escape(s.data());
+}
+
+
+BENCHMARK_F(TextFixture, stream_replacer, 5, 100)
+{
+  nonstd::string_utils::stream_replacer replacer{"Jesus", "Logos"};
+  std::string_view sv = text;
+  std::size_t size = 0;
+  auto count = [&](std::string_view part) { size += part.size(); };
+  for (std::size_t i = 0; i < sv.size(); i += 65536)
+    replacer.feed(sv.substr(i, 65536), count);
+  replacer.finish(count);
+  escape(&size);
+}
+
+
+BENCHMARK_F(TextFixture, tokenizer_lines, 5, 100)
+{
+  nonstd::string_utils::tokenizer lines{"\n"};
+  std::string_view sv = text;
+  std::size_t count = 0;
+  auto counter = [&](std::string_view) { count++; };
+  for (std::size_t i = 0; i < sv.size(); i += 65536)
+    lines.feed(sv.substr(i, 65536), counter);
+  lines.finish(counter);
+  escape(&count);
+}
+
+
+BENCHMARK(file, ifstream_lines, 5, 10)
+{
+  std::ifstream fs{"text/OEB-2016.1-US.txt"};
+  std::stringstream ss;
+  ss << fs.rdbuf();
+  auto text = ss.str();
+  std::size_t count = 0;
+  for ([[maybe_unused]] auto line : nonstd::string_utils::lines(text))
+    count++;
+  escape(&count);
+}
+
+
+#ifdef NONSTD_STRING_UTILS_MMAP
+BENCHMARK(file, mapped_file_lines, 5, 10)
+{
+  nonstd::string_utils::mapped_file file{"text/OEB-2016.1-US.txt"};
+  std::size_t count = 0;
+  for ([[maybe_unused]] auto line : nonstd::string_utils::lines(file))
+    count++;
+  escape(&count);
+}
+
+
+BENCHMARK_F(MappedFixture, split, 5, 10)
+{
+  auto v = nonstd::string_utils::split(file, "\n");
+  escape(v.data());
+}
+#endif
+
+
+BENCHMARK_F(TextFixture, lines, 10, 100)
+{
+  std::size_t size = 0;
+  for (auto line : nonstd::string_utils::lines(text))
+    size += line.size();
+  escape(&size);
+}
+
+
+BENCHMARK_F(TextFixture, split_lines_trim_cr, 10, 100)
 {
-  nonstd::string_utils::split(s, ',');
+  std::size_t size = 0;
+  for (auto line : nonstd::string_utils::split(text, "\n")) {
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+    size += line.size();
+  }
+  escape(&size);
 }
 
 
+BENCHMARK_F(TextFixture, parallel_split_1, 5, 100)
+{
+  auto v = nonstd::string_utils::parallel_split(text, " ", 1);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, parallel_split_2, 5, 100)
+{
+  auto v = nonstd::string_utils::parallel_split(text, " ", 2);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, parallel_split_4, 5, 100)
+{
+  auto v = nonstd::string_utils::parallel_split(text, " ", 4);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, parallel_split_8, 5, 100)
+{
+  auto v = nonstd::string_utils::parallel_split(text, " ", 8);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, parallel_split_all_cores, 5, 100)
+{
+  auto v = nonstd::string_utils::parallel_split(text, " ", 0);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, delimiter_index_build, 10, 100)
+{
+  nonstd::string_utils::delimiter_index index{text, "\n"};
+  escape(&index);
+}
+
+
+BENCHMARK_F(TextFixture, split_lines_twice, 10, 100)
+{
+  auto a = nonstd::string_utils::split(text, "\n");
+  auto b = nonstd::string_utils::split(text, "\n");
+  escape(a.data());
+  escape(b.data());
+}
+
+
+BENCHMARK_F(TextFixture, delimiter_index_split_lines_twice, 10, 100)
+{
+  nonstd::string_utils::delimiter_index index{text, "\n"};
+  auto a = index.split();
+  auto b = index.split();
+  escape(a.data());
+  escape(b.data());
+}
+
+
+BENCHMARK_F(TextFixture, split_two_byte_token, 10, 100)
+{
+  auto v = nonstd::string_utils::split(text, ". ");
+  escape(v.data());
+}
+
+
+BENCHMARK_F(TextFixture, split_two_byte_constant_token, 10, 100)
+{
+  auto v = nonstd::string_utils::split<'.', ' '>(text);
+  escape(v.data());
+}
+
+
+BENCHMARK_F(CrlfFixture, split_lines, 10, 100)
+{
+  auto v = nonstd::string_utils::split(text, "\r\n");
+  escape(v.data());
+}
+
+
+BENCHMARK_F(CrlfFixture, split_lines_constant_token, 10, 100)
+{
+  auto v = nonstd::string_utils::split<'\r', '\n'>(text);
+  escape(v.data());
+}
+
+
+const char* key_values = "host=example.com; port=8080; user=admin; timeout=30; retries=3; "
+    "mode=fast; level=debug; path=/var/log; size=1024; color=blue; lang=en; zone=utc; "
+    "a=1; b=2; c=3; d=4; e=5; f=6; g=7; h=8; i=9; j=10; k=11; l=12; m=13; n=14; o=15";
+
+
+BENCHMARK(string, split_key_values, 100, 100000)
+{
+  auto v = nonstd::string_utils::split(key_values, "; ");
+  escape(v.data());
+}
+
+
+BENCHMARK(string, split_key_values_constant_token, 100, 100000)
+{
+  auto v = nonstd::string_utils::split<';', ' '>(key_values);
+  escape(v.data());
+}
+
+
+/*
 BENCHMARK_F(RandomFixture, split_at_count, 100, 100000)
 {
   nonstd::string_utils::ascii::split(s, 100, 1);
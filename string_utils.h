@@ -2,438 +2,4930 @@
 #define NONSTD_STRING_UTILS_H
 
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <locale>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #if __GNUC__ >= 8 && __has_include(<charconv>)
   #define NONSTD_STRING_UTILS_CHARCONV
-  #define NONSTD_STRING_UTILS_CHARCONV_INTEGRAL_TYPES_ONLY
   #include <charconv>
+  #ifndef __cpp_lib_to_chars
+    #define NONSTD_STRING_UTILS_CHARCONV_INTEGRAL_TYPES_ONLY
+  #endif
+#endif
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+  #define NONSTD_STRING_UTILS_LITTLE_ENDIAN
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define NONSTD_STRING_UTILS_X86
+  #define NONSTD_STRING_UTILS_TARGET(isa) __attribute__((target(isa), noinline))
+  #include <immintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+  #define NONSTD_STRING_UTILS_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
 #endif
 
 
+namespace nonstd::string_utils
+{
+
+
+// Instruction set tiers of the vectorized kernels, each tier includes the ones before it
+enum class simd_level { scalar, sse2, avx2, avx512bw };
+
+
+#ifdef NONSTD_STRING_UTILS_CHARCONV
+  // Outcome of parse_delimited, count values were written and on failure field is the
+  // first malformed field
+  struct parse_result
+  {
+    std::size_t count = 0;
+    std::string_view field{};
+    std::errc ec{};
+
+    explicit operator bool() const { return ec == std::errc{}; }
+  };
+#endif  // NONSTD_STRING_UTILS_CHARCONV
+
+
+}  // namespace nonstd::string_utils
+
+
 namespace nonstd::string_utils::detail
 {
 
 
-template<typename I, typename F> void transform(I start, I stop, F func)
+// SWAR digit parsing, eight ASCII digits are validated and combined with three multiplies
+//
+
+inline constexpr std::uint64_t pow10_table[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+    10000000, 100000000};
+
+
+inline std::uint64_t load_eight(const char* p)
 {
-  while (start != stop) {
-    *start = func(*start);
-    start++;
-  }
+  std::uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
 }
 
 
-#ifdef NONSTD_STRING_UTILS_CHARCONV
-  template <typename T> T parse_number(std::string_view sv, int base = 10)
-  {
-    T value{};
-    std::from_chars(sv.data(), sv.data() + sv.size(), value, base);
-    return value;
+// Loads fewer than eight bytes straight into a register, going through memory would stall
+// the following eight byte read on store forwarding
+inline std::uint64_t load_partial(const char* p, std::size_t n)
+{
+  std::uint64_t v = 0;
+  std::size_t i = 0;
+  if (n & 4) {
+    std::uint32_t x;
+    std::memcpy(&x, p, sizeof(x));
+    v = x;
+    i = 4;
   }
-#endif  // NONSTD_STRING_UTILS_CHARCONV
+  if (n & 2) {
+    std::uint16_t x;
+    std::memcpy(&x, p + i, sizeof(x));
+    v |= std::uint64_t{x} << (8 * i);
+    i += 2;
+  }
+  if (n & 1)
+    v |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+  return v;
+}
+
+
+// Every byte that is an ASCII digit becomes 0x33, carries only travel towards later bytes
+inline std::uint64_t digit_bytes(std::uint64_t v)
+{
+  return (v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4);
+}
+
+
+// First byte is the most significant digit (little endian load)
+inline std::uint32_t parse_eight_digits(std::uint64_t v)
+{
+  v -= 0x3030303030303030;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+      (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+  return static_cast<std::uint32_t>(v);
+}
 
 
-template<typename I> bool compare(I a, I b, const I last)
+// Exactly N digits, false on anything else or when the value does not fit into T
+template <typename T, std::size_t N> bool parse_fixed(const char* p, T& value)
 {
-  if (*a != *b)
+  static_assert(std::is_unsigned_v<T> && N > 0 && N <= std::numeric_limits<T>::digits10 + 1,
+      "parse_fixed expects an unsigned type wide enough for N digits");
+  std::uint64_t u = 0;
+  std::size_t i = 0;
+
+#ifdef NONSTD_STRING_UTILS_LITTLE_ENDIAN
+  for (; i + 8 <= N; i += 8) {
+    auto v = load_eight(p + i);
+    if (digit_bytes(v) != 0x3333333333333333)
+      return false;
+    std::uint64_t chunk = parse_eight_digits(v);
+    if constexpr (N > 19) {
+      if (u > (std::numeric_limits<std::uint64_t>::max() - chunk) / 100000000)
+        return false;
+    }
+    u = u * 100000000 + chunk;
+  }
+  if constexpr (N % 8 != 0) {
+    constexpr std::size_t rest = N % 8;
+    auto v = load_partial(p + i, rest);
+    v = (v << (8 * (8 - rest))) | (0x3030303030303030 >> (8 * rest));
+    if (digit_bytes(v) != 0x3333333333333333)
+      return false;
+    std::uint64_t chunk = parse_eight_digits(v);
+    if constexpr (N > 19) {
+      if (u > (std::numeric_limits<std::uint64_t>::max() - chunk) / pow10_table[rest])
+        return false;
+    }
+    u = u * pow10_table[rest] + chunk;
+  }
+#else
+  for (; i < N; i++) {
+    auto d = static_cast<unsigned char>(p[i] - '0');
+    if (d > 9)
+      return false;
+    if constexpr (N > 19) {
+      if (u > (std::numeric_limits<std::uint64_t>::max() - d) / 10)
+        return false;
+    }
+    u = u * 10 + d;
+  }
+#endif
+
+  if (u > std::numeric_limits<T>::max())
     return false;
+  value = static_cast<T>(u);
+  return true;
+}
 
-  while (b != last && *(++a) == *(++b));
 
-  if (b == last)
-    return true;
+// Floating point parsing after Eisel and Lemire, the decimal significand is multiplied by a
+// 128 bit approximation of the power of five. Numbers with more than 19 significant digits
+// that end up close to a rounding boundary fall back to exact decimal arithmetic
+//
 
-  return false;
+// Fields of the binary formats and the range of exponents where the fast paths apply
+template <typename T> struct float_format;
+
+
+template <> struct float_format<double>
+{
+  using bits_type = std::uint64_t;
+  static constexpr int mantissa_bits = 52;
+  static constexpr int exponent_bits = 11;
+  static constexpr int minimum_exponent = -1023;
+  static constexpr int infinite_power = 0x7FF;
+  static constexpr int smallest_power_of_ten = -342;
+  static constexpr int largest_power_of_ten = 308;
+  static constexpr int min_round_to_even = -4;
+  static constexpr int max_round_to_even = 23;
+  static constexpr int max_exact_power = 22;
+  static constexpr std::uint64_t max_exact_mantissa = std::uint64_t{1} << 53;
+  static constexpr double exact_powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+      1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+
+template <> struct float_format<float>
+{
+  using bits_type = std::uint32_t;
+  static constexpr int mantissa_bits = 23;
+  static constexpr int exponent_bits = 8;
+  static constexpr int minimum_exponent = -127;
+  static constexpr int infinite_power = 0xFF;
+  static constexpr int smallest_power_of_ten = -65;
+  static constexpr int largest_power_of_ten = 38;
+  static constexpr int min_round_to_even = -17;
+  static constexpr int max_round_to_even = 10;
+  static constexpr int max_exact_power = 10;
+  static constexpr std::uint64_t max_exact_mantissa = std::uint64_t{1} << 24;
+  static constexpr float exact_powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f,
+      1e8f, 1e9f, 1e10f};
+};
+
+
+// 5^q for q in [-342, 308] as 128 bit significands with the top bit set, high word first,
+// negative powers are rounded up
+inline constexpr int smallest_power_of_five = -342;
+inline constexpr std::uint64_t power_of_five_128[] = {
+    0xEEF453D6923BD65A, 0x113FAA2906A13B3F,
+    0x9558B4661B6565F8, 0x4AC7CA59A424C507,
+    0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649,
+    0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC,
+    0x91D8A02BB6C10594, 0x79071B9B8A4BE869,
+    0xB64EC836A47146F9, 0x9748E2826CDEE284,
+    0xE3E27A444D8D98B7, 0xFD1B1B2308169B25,
+    0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7,
+    0xB208EF855C969F4F, 0xBDBD2D335E51A935,
+    0xDE8B2B66B3BC4723, 0xAD2C788035E61382,
+    0x8B16FB203055AC76, 0x4C3BCB5021AFCC31,
+    0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D,
+    0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D,
+    0x87D4713D6F33AA6B, 0x8672648C40E5AD68,
+    0xA9C98D8CCB009506, 0x680EFDAF511F18C2,
+    0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2,
+    0x84A57695FE98746D, 0x014BB630F7604B57,
+    0xA5CED43B7E3E9188, 0x419EA3BD35385E2D,
+    0xCF42894A5DCE35EA, 0x52064CAC828675B9,
+    0x818995CE7AA0E1B2, 0x7343EFEBD1940993,
+    0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8,
+    0xCA66FA129F9B60A6, 0xD41A26E077774EF6,
+    0xFD00B897478238D0, 0x8920B098955522B4,
+    0x9E20735E8CB16382, 0x55B46E5F5D5535B0,
+    0xC5A890362FDDBC62, 0xEB2189F734AA831D,
+    0xF712B443BBD52B7B, 0xA5E9EC7501D523E4,
+    0x9A6BB0AA55653B2D, 0x47B233C92125366E,
+    0xC1069CD4EABE89F8, 0x999EC0BB696E840A,
+    0xF148440A256E2C76, 0xC00670EA43CA250D,
+    0x96CD2A865764DBCA, 0x380406926A5E5728,
+    0xBC807527ED3E12BC, 0xC605083704F5ECF2,
+    0xEBA09271E88D976B, 0xF7864A44C633682E,
+    0x93445B8731587EA3, 0x7AB3EE6AFBE0211D,
+    0xB8157268FDAE9E4C, 0x5960EA05BAD82964,
+    0xE61ACF033D1A45DF, 0x6FB92487298E33BD,
+    0x8FD0C16206306BAB, 0xA5D3B6D479F8E056,
+    0xB3C4F1BA87BC8696, 0x8F48A4899877186C,
+    0xE0B62E2929ABA83C, 0x331ACDABFE94DE87,
+    0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14,
+    0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9,
+    0xDB71E91432B1A24A, 0xC9E82CD9F69D6150,
+    0x892731AC9FAF056E, 0xBE311C083A225CD2,
+    0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406,
+    0xD64D3D9DB981787D, 0x092CBBCCDAD5B108,
+    0x85F0468293F0EB4E, 0x25BBF56008C58EA5,
+    0xA76C582338ED2621, 0xAF2AF2B80AF6F24E,
+    0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1,
+    0x82CCA4DB847945CA, 0x50D98D9FC890ED4D,
+    0xA37FCE126597973C, 0xE50FF107BAB528A0,
+    0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8,
+    0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A,
+    0x9FAACF3DF73609B1, 0x77B191618C54E9AC,
+    0xC795830D75038C1D, 0xD59DF5B9EF6A2417,
+    0xF97AE3D0D2446F25, 0x4B0573286B44AD1D,
+    0x9BECCE62836AC577, 0x4EE367F9430AEC32,
+    0xC2E801FB244576D5, 0x229C41F793CDA73F,
+    0xF3A20279ED56D48A, 0x6B43527578C1110F,
+    0x9845418C345644D6, 0x830A13896B78AAA9,
+    0xBE5691EF416BD60C, 0x23CC986BC656D553,
+    0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8,
+    0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9,
+    0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53,
+    0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68,
+    0x91376C36D99995BE, 0x23100809B9C21FA1,
+    0xB58547448FFFFB2D, 0xABD40A0C2832A78A,
+    0xE2E69915B3FFF9F9, 0x16C90C8F323F516C,
+    0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3,
+    0xB1442798F49FFB4A, 0x99CD11CFDF41779C,
+    0xDD95317F31C7FA1D, 0x40405643D711D583,
+    0x8A7D3EEF7F1CFC52, 0x482835EA666B2572,
+    0xAD1C8EAB5EE43B66, 0xDA3243650005EECF,
+    0xD863B256369D4A40, 0x90BED43E40076A82,
+    0x873E4F75E2224E68, 0x5A7744A6E804A291,
+    0xA90DE3535AAAE202, 0x711515D0A205CB36,
+    0xD3515C2831559A83, 0x0D5A5B44CA873E03,
+    0x8412D9991ED58091, 0xE858790AFE9486C2,
+    0xA5178FFF668AE0B6, 0x626E974DBE39A872,
+    0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F,
+    0x80FA687F881C7F8E, 0x7CE66634BC9D0B99,
+    0xA139029F6A239F72, 0x1C1FFFC1EBC44E80,
+    0xC987434744AC874E, 0xA327FFB266B56220,
+    0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8,
+    0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9,
+    0xC4CE17B399107C22, 0xCB550FB4384D21D3,
+    0xF6019DA07F549B2B, 0x7E2A53A146606A48,
+    0x99C102844F94E0FB, 0x2EDA7444CBFC426D,
+    0xC0314325637A1939, 0xFA911155FEFB5308,
+    0xF03D93EEBC589F88, 0x793555AB7EBA27CA,
+    0x96267C7535B763B5, 0x4BC1558B2F3458DE,
+    0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16,
+    0xEA9C227723EE8BCB, 0x465E15A979C1CADC,
+    0x92A1958A7675175F, 0x0BFACD89EC191EC9,
+    0xB749FAED14125D36, 0xCEF980EC671F667B,
+    0xE51C79A85916F484, 0x82B7E12780E7401A,
+    0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810,
+    0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15,
+    0xDFBDCECE67006AC9, 0x67A791E093E1D49A,
+    0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0,
+    0xAECC49914078536D, 0x58FAE9F773886E18,
+    0xDA7F5BF590966848, 0xAF39A475506A899E,
+    0x888F99797A5E012D, 0x6D8406C952429603,
+    0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83,
+    0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64,
+    0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F,
+    0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E,
+    0xD0601D8EFC57B08B, 0xF13B94DAF124DA26,
+    0x823C12795DB6CE57, 0x76C53D08D6B70858,
+    0xA2CB1717B52481ED, 0x54768C4B0C64CA6E,
+    0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09,
+    0xFE5D54150B090B02, 0xD3F93B35435D7C4C,
+    0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF,
+    0xC6B8E9B0709F109A, 0x359AB6419CA1091B,
+    0xF867241C8CC6D4C0, 0xC30163D203C94B62,
+    0x9B407691D7FC44F8, 0x79E0DE63425DCF1D,
+    0xC21094364DFB5636, 0x985915FC12F542E4,
+    0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D,
+    0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42,
+    0xBD8430BD08277231, 0x50C6FF782A838353,
+    0xECE53CEC4A314EBD, 0xA4F8BF5635246428,
+    0x940F4613AE5ED136, 0x871B7795E136BE99,
+    0xB913179899F68584, 0x28E2557B59846E3F,
+    0xE757DD7EC07426E5, 0x331AEADA2FE589CF,
+    0x9096EA6F3848984F, 0x3FF0D2C85DEF7621,
+    0xB4BCA50B065ABE63, 0x0FED077A756B53A9,
+    0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894,
+    0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C,
+    0xB080392CC4349DEC, 0xBD8D794D96AACFB3,
+    0xDCA04777F541C567, 0xECF0D7A0FC5583A0,
+    0x89E42CAAF9491B60, 0xF41686C49DB57244,
+    0xAC5D37D5B79B6239, 0x311C2875C522CED5,
+    0xD77485CB25823AC7, 0x7D633293366B828B,
+    0x86A8D39EF77164BC, 0xAE5DFF9C02033197,
+    0xA8530886B54DBDEB, 0xD9F57F830283FDFC,
+    0xD267CAA862A12D66, 0xD072DF63C324FD7B,
+    0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D,
+    0xA46116538D0DEB78, 0x52D9BE85F074E608,
+    0xCD795BE870516656, 0x67902E276C921F8B,
+    0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6,
+    0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4,
+    0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD,
+    0xFAD2A4B13D1B5D6C, 0x796B805720085F81,
+    0x9CC3A6EEC6311A63, 0xCBE3303674053BB0,
+    0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C,
+    0xF4F1B4D515ACB93B, 0xEE92FB5515482D44,
+    0x991711052D8BF3C5, 0x751BDD152D4D1C4A,
+    0xBF5CD54678EEF0B6, 0xD262D45A78A0635D,
+    0xEF340A98172AACE4, 0x86FB897116C87C34,
+    0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0,
+    0xBAE0A846D2195712, 0x8974836059CCA109,
+    0xE998D258869FACD7, 0x2BD1A438703FC94B,
+    0x91FF83775423CC06, 0x7B6306A34627DDCF,
+    0xB67F6455292CBF08, 0x1A3BC84C17B1D542,
+    0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93,
+    0x8E938662882AF53E, 0x547EB47B7282EE9C,
+    0xB23867FB2A35B28D, 0xE99E619A4F23AA43,
+    0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4,
+    0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04,
+    0xAE0B158B4738705E, 0x9624AB50B148D445,
+    0xD98DDAEE19068C76, 0x3BADD624DD9B0957,
+    0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6,
+    0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C,
+    0xD47487CC8470652B, 0x7647C3200069671F,
+    0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073,
+    0xA5FB0A17C777CF09, 0xF468107100525890,
+    0xCF79CC9DB955C2CC, 0x7182148D4066EEB4,
+    0x81AC1FE293D599BF, 0xC6F14CD848405530,
+    0xA21727DB38CB002F, 0xB8ADA00E5A506A7C,
+    0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C,
+    0xFD442E4688BD304A, 0x908F4A166D1DA663,
+    0x9E4A9CEC15763E2E, 0x9A598E4E043287FE,
+    0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD,
+    0xF7549530E188C128, 0xD12BEE59E68EF47C,
+    0x9A94DD3E8CF578B9, 0x82BB74F8301958CE,
+    0xC13A148E3032D6E7, 0xE36A52363C1FAF01,
+    0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1,
+    0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9,
+    0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7,
+    0xEBDF661791D60F56, 0x111B495B3464AD21,
+    0x936B9FCEBB25C995, 0xCAB10DD900BEEC34,
+    0xB84687C269EF3BFB, 0x3D5D514F40EEA742,
+    0xE65829B3046B0AFA, 0x0CB4A5A3112A5112,
+    0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB,
+    0xB3F4E093DB73A093, 0x59ED216765690F56,
+    0xE0F218B8D25088B8, 0x306869C13EC3532C,
+    0x8C974F7383725573, 0x1E414218C73A13FB,
+    0xAFBD2350644EEACF, 0xE5D1929EF90898FA,
+    0xDBAC6C247D62A583, 0xDF45F746B74ABF39,
+    0x894BC396CE5DA772, 0x6B8BBA8C328EB783,
+    0xAB9EB47C81F5114F, 0x066EA92F3F326564,
+    0xD686619BA27255A2, 0xC80A537B0EFEFEBD,
+    0x8613FD0145877585, 0xBD06742CE95F5F36,
+    0xA798FC4196E952E7, 0x2C48113823B73704,
+    0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5,
+    0x82EF85133DE648C4, 0x9A984D73DBE722FB,
+    0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA,
+    0xCC963FEE10B7D1B3, 0x318DF905079926A8,
+    0xFFBBCFE994E5C61F, 0xFDF17746497F7052,
+    0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633,
+    0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0,
+    0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0,
+    0x9C1661A651213E2D, 0x06BEA10CA65C084E,
+    0xC31BFA0FE5698DB8, 0x486E494FCFF30A62,
+    0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA,
+    0x986DDB5C6B3A76B7, 0xF89629465A75E01C,
+    0xBE89523386091465, 0xF6BBB397F1135823,
+    0xEE2BA6C0678B597F, 0x746AA07DED582E2C,
+    0x94DB483840B717EF, 0xA8C2A44EB4571CDC,
+    0xBA121A4650E4DDEB, 0x92F34D62616CE413,
+    0xE896A0D7E51E1566, 0x77B020BAF9C81D17,
+    0x915E2486EF32CD60, 0x0ACE1474DC1D122E,
+    0xB5B5ADA8AAFF80B8, 0x0D819992132456BA,
+    0xE3231912D5BF60E6, 0x10E1FFF697ED6C69,
+    0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1,
+    0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2,
+    0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE,
+    0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B,
+    0xAD4AB7112EB3929D, 0x86C16C98D2C953C6,
+    0xD89D64D57A607744, 0xE871C7BF077BA8B7,
+    0x87625F056C7C4A8B, 0x11471CD764AD4972,
+    0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF,
+    0xD389B47879823479, 0x4AFF1D108D4EC2C3,
+    0x843610CB4BF160CB, 0xCEDF722A585139BA,
+    0xA54394FE1EEDB8FE, 0xC2974EB4EE658828,
+    0xCE947A3DA6A9273E, 0x733D226229FEEA32,
+    0x811CCC668829B887, 0x0806357D5A3F525F,
+    0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7,
+    0xC9BCFF6034C13052, 0xFC89B393DD02F0B5,
+    0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2,
+    0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D,
+    0xC5029163F384A931, 0x0A9E795E65D4DF11,
+    0xF64335BCF065D37D, 0x4D4617B5FF4A16D5,
+    0x99EA0196163FA42E, 0x504BCED1BF8E4E45,
+    0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6,
+    0xF07DA27A82C37088, 0x5D767327BB4E5A4C,
+    0x964E858C91BA2655, 0x3A6A07F8D510F86F,
+    0xBBE226EFB628AFEA, 0x890489F70A55368B,
+    0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E,
+    0x92C8AE6B464FC96F, 0x3B0B8BC90012929D,
+    0xB77ADA0617E3BBCB, 0x09CE6EBB40173744,
+    0xE55990879DDCAABD, 0xCC420A6A101D0515,
+    0x8F57FA54C2A9EAB6, 0x9FA946824A12232D,
+    0xB32DF8E9F3546564, 0x47939822DC96ABF9,
+    0xDFF9772470297EBD, 0x59787E2B93BC56F7,
+    0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A,
+    0xAEFAE51477A06B03, 0xEDE622920B6B23F1,
+    0xDAB99E59958885C4, 0xE95FAB368E45ECED,
+    0x88B402F7FD75539B, 0x11DBCB0218EBB414,
+    0xAAE103B5FCD2A881, 0xD652BDC29F26A119,
+    0xD59944A37C0752A2, 0x4BE76D3346F0495F,
+    0x857FCAE62D8493A5, 0x6F70A4400C562DDB,
+    0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952,
+    0xD097AD07A71F26B2, 0x7E2000A41346A7A7,
+    0x825ECC24C873782F, 0x8ED400668C0C28C8,
+    0xA2F67F2DFA90563B, 0x728900802F0F32FA,
+    0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9,
+    0xFEA126B7D78186BC, 0xE2F610C84987BFA8,
+    0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9,
+    0xC6EDE63FA05D3143, 0x91503D1C79720DBB,
+    0xF8A95FCF88747D94, 0x75A44C6397CE912A,
+    0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA,
+    0xC24452DA229B021B, 0xFBE85BADCE996168,
+    0xF2D56790AB41C2A2, 0xFAE27299423FB9C3,
+    0x97C560BA6B0919A5, 0xDCCD879FC967D41A,
+    0xBDB6B8E905CB600F, 0x5400E987BBC1C920,
+    0xED246723473E3813, 0x290123E9AAB23B68,
+    0x9436C0760C86E30B, 0xF9A0B6720AAF6521,
+    0xB94470938FA89BCE, 0xF808E40E8D5B3E69,
+    0xE7958CB87392C2C2, 0xB60B1D1230B20E04,
+    0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2,
+    0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3,
+    0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0,
+    0x8D590723948A535F, 0x579C487E5A38AD0E,
+    0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851,
+    0xDCDB1B2798182244, 0xF8E431456CF88E65,
+    0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF,
+    0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F,
+    0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F,
+    0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9,
+    0xA87FEA27A539E9A5, 0x3F2398D747B36224,
+    0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD,
+    0x83A3EEEEF9153E89, 0x1953CF68300424AC,
+    0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7,
+    0xCDB02555653131B6, 0x3792F412CB06794D,
+    0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0,
+    0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4,
+    0xC8DE047564D20A8B, 0xF245825A5A445275,
+    0xFB158592BE068D2E, 0xEED6E2F0F0D56712,
+    0x9CED737BB6C4183D, 0x55464DD69685606B,
+    0xC428D05AA4751E4C, 0xAA97E14C3C26B886,
+    0xF53304714D9265DF, 0xD53DD99F4B3066A8,
+    0x993FE2C6D07B7FAB, 0xE546A8038EFE4029,
+    0xBF8FDB78849A5F96, 0xDE98520472BDD033,
+    0xEF73D256A5C0F77C, 0x963E66858F6D4440,
+    0x95A8637627989AAD, 0xDDE7001379A44AA8,
+    0xBB127C53B17EC159, 0x5560C018580D5D52,
+    0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6,
+    0x9226712162AB070D, 0xCAB3961304CA70E8,
+    0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22,
+    0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A,
+    0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242,
+    0xB267ED1940F1C61C, 0x55F038B237591ED3,
+    0xDF01E85F912E37A3, 0x6B6C46DEC52F6688,
+    0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015,
+    0xAE397D8AA96C1B77, 0xABEC975E0A0D081A,
+    0xD9C7DCED53C72255, 0x96E7BD358C904A21,
+    0x881CEA14545C7575, 0x7E50D64177DA2E54,
+    0xAA242499697392D2, 0xDDE50BD1D5D0B9E9,
+    0xD4AD2DBFC3D07787, 0x955E4EC64B44E864,
+    0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E,
+    0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E,
+    0xCFB11EAD453994BA, 0x67DE18EDA5814AF2,
+    0x81CEB32C4B43FCF4, 0x80EACF948770CED7,
+    0xA2425FF75E14FC31, 0xA1258379A94D028D,
+    0xCAD2F7F5359A3B3E, 0x096EE45813A04330,
+    0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC,
+    0x9E74D1B791E07E48, 0x775EA264CF55347E,
+    0xC612062576589DDA, 0x95364AFE032A819E,
+    0xF79687AED3EEC551, 0x3A83DDBD83F52205,
+    0x9ABE14CD44753B52, 0xC4926A9672793543,
+    0xC16D9A0095928A27, 0x75B7053C0F178294,
+    0xF1C90080BAF72CB1, 0x5324C68B12DD6339,
+    0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04,
+    0xBCE5086492111AEA, 0x88F4BB1CA6BCF585,
+    0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6,
+    0x9392EE8E921D5D07, 0x3AFF322E62439FD0,
+    0xB877AA3236A4B449, 0x09BEFEB9FAD487C3,
+    0xE69594BEC44DE15B, 0x4C2EBE687989A9B4,
+    0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11,
+    0xB424DC35095CD80F, 0x538484C19EF38C95,
+    0xE12E13424BB40E13, 0x2865A5F206B06FBA,
+    0x8CBCCC096F5088CB, 0xF93F87B7442E45D4,
+    0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749,
+    0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C,
+    0x89705F4136B4A597, 0x31680A88F8953031,
+    0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E,
+    0xD6BF94D5E57A42BC, 0x3D32907604691B4D,
+    0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110,
+    0xA7C5AC471B478423, 0x0FCF80DC33721D54,
+    0xD1B71758E219652B, 0xD3C36113404EA4A9,
+    0x83126E978D4FDF3B, 0x645A1CAC083126EA,
+    0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4,
+    0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD,
+    0x8000000000000000, 0x0000000000000000,
+    0xA000000000000000, 0x0000000000000000,
+    0xC800000000000000, 0x0000000000000000,
+    0xFA00000000000000, 0x0000000000000000,
+    0x9C40000000000000, 0x0000000000000000,
+    0xC350000000000000, 0x0000000000000000,
+    0xF424000000000000, 0x0000000000000000,
+    0x9896800000000000, 0x0000000000000000,
+    0xBEBC200000000000, 0x0000000000000000,
+    0xEE6B280000000000, 0x0000000000000000,
+    0x9502F90000000000, 0x0000000000000000,
+    0xBA43B74000000000, 0x0000000000000000,
+    0xE8D4A51000000000, 0x0000000000000000,
+    0x9184E72A00000000, 0x0000000000000000,
+    0xB5E620F480000000, 0x0000000000000000,
+    0xE35FA931A0000000, 0x0000000000000000,
+    0x8E1BC9BF04000000, 0x0000000000000000,
+    0xB1A2BC2EC5000000, 0x0000000000000000,
+    0xDE0B6B3A76400000, 0x0000000000000000,
+    0x8AC7230489E80000, 0x0000000000000000,
+    0xAD78EBC5AC620000, 0x0000000000000000,
+    0xD8D726B7177A8000, 0x0000000000000000,
+    0x878678326EAC9000, 0x0000000000000000,
+    0xA968163F0A57B400, 0x0000000000000000,
+    0xD3C21BCECCEDA100, 0x0000000000000000,
+    0x84595161401484A0, 0x0000000000000000,
+    0xA56FA5B99019A5C8, 0x0000000000000000,
+    0xCECB8F27F4200F3A, 0x0000000000000000,
+    0x813F3978F8940984, 0x4000000000000000,
+    0xA18F07D736B90BE5, 0x5000000000000000,
+    0xC9F2C9CD04674EDE, 0xA400000000000000,
+    0xFC6F7C4045812296, 0x4D00000000000000,
+    0x9DC5ADA82B70B59D, 0xF020000000000000,
+    0xC5371912364CE305, 0x6C28000000000000,
+    0xF684DF56C3E01BC6, 0xC732000000000000,
+    0x9A130B963A6C115C, 0x3C7F400000000000,
+    0xC097CE7BC90715B3, 0x4B9F100000000000,
+    0xF0BDC21ABB48DB20, 0x1E86D40000000000,
+    0x96769950B50D88F4, 0x1314448000000000,
+    0xBC143FA4E250EB31, 0x17D955A000000000,
+    0xEB194F8E1AE525FD, 0x5DCFAB0800000000,
+    0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000,
+    0xB7ABC627050305AD, 0xF14A3D9E40000000,
+    0xE596B7B0C643C719, 0x6D9CCD05D0000000,
+    0x8F7E32CE7BEA5C6F, 0xE4820023A2000000,
+    0xB35DBF821AE4F38B, 0xDDA2802C8A800000,
+    0xE0352F62A19E306E, 0xD50B2037AD200000,
+    0x8C213D9DA502DE45, 0x4526F422CC340000,
+    0xAF298D050E4395D6, 0x9670B12B7F410000,
+    0xDAF3F04651D47B4C, 0x3C0CDD765F114000,
+    0x88D8762BF324CD0F, 0xA5880A69FB6AC800,
+    0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00,
+    0xD5D238A4ABE98068, 0x72A4904598D6D880,
+    0x85A36366EB71F041, 0x47A6DA2B7F864750,
+    0xA70C3C40A64E6C51, 0x999090B65F67D924,
+    0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D,
+    0x82818F1281ED449F, 0xBFF8F10E7A8921A4,
+    0xA321F2D7226895C7, 0xAFF72D52192B6A0D,
+    0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490,
+    0xFEE50B7025C36A08, 0x02F236D04753D5B4,
+    0x9F4F2726179A2245, 0x01D762422C946590,
+    0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5,
+    0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2,
+    0x9B934C3B330C8577, 0x63CC55F49F88EB2F,
+    0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB,
+    0xF316271C7FC3908A, 0x8BEF464E3945EF7A,
+    0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC,
+    0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317,
+    0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD,
+    0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A,
+    0xB975D6B6EE39E436, 0xB3E2FD538E122B44,
+    0xE7D34C64A9C85D44, 0x60DBBCA87196B616,
+    0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD,
+    0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41,
+    0xE264589A4DCDAB14, 0xC696963C7EED2DD1,
+    0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2,
+    0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB,
+    0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE,
+    0x8A2DBF142DFCC7AB, 0x6E3569326C784337,
+    0xACB92ED9397BF996, 0x49C2C37F07965404,
+    0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906,
+    0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3,
+    0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C,
+    0xD2D80DB02AABD62B, 0xF50A3FA490C30190,
+    0x83C7088E1AAB65DB, 0x792667C6DA79E0FA,
+    0xA4B8CAB1A1563F52, 0x577001B891185938,
+    0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86,
+    0x80B05E5AC60B6178, 0x544F8158315B05B4,
+    0xA0DC75F1778E39D6, 0x696361AE3DB1C721,
+    0xC913936DD571C84C, 0x03BC3A19CD1E38E9,
+    0xFB5878494ACE3A5F, 0x04AB48A04065C723,
+    0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76,
+    0xC45D1DF942711D9A, 0x3BA5D0BD324F8394,
+    0xF5746577930D6500, 0xCA8F44EC7EE36479,
+    0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB,
+    0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E,
+    0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E,
+    0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12,
+    0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97,
+    0xEA1575143CF97226, 0xF52D09D71A3293BD,
+    0x924D692CA61BE758, 0x593C2626705F9C56,
+    0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C,
+    0xE498F455C38B997A, 0x0B6DFB9C0F956447,
+    0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC,
+    0xB2977EE300C50FE7, 0x58EDEC91EC2CB657,
+    0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED,
+    0x8B865B215899F46C, 0xBD79E0D20082EE74,
+    0xAE67F1E9AEC07187, 0xECD8590680A3AA11,
+    0xDA01EE641A708DE9, 0xE80E6F4820CC9495,
+    0x884134FE908658B2, 0x3109058D147FDCDD,
+    0xAA51823E34A7EEDE, 0xBD4B46F0599FD415,
+    0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A,
+    0x850FADC09923329E, 0x03E2CF6BC604DDB0,
+    0xA6539930BF6BFF45, 0x84DB8346B786151C,
+    0xCFE87F7CEF46FF16, 0xE612641865679A63,
+    0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E,
+    0xA26DA3999AEF7749, 0xE3BE5E330F38F09D,
+    0xCB090C8001AB551C, 0x5CADF5BFD3072CC5,
+    0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6,
+    0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA,
+    0xC646D63501A1511D, 0xB281E1FD541501B8,
+    0xF7D88BC24209A565, 0x1F225A7CA91A4226,
+    0x9AE757596946075F, 0x3375788DE9B06958,
+    0xC1A12D2FC3978937, 0x0052D6B1641C83AE,
+    0xF209787BB47D6B84, 0xC0678C5DBD23A49A,
+    0x9745EB4D50CE6332, 0xF840B7BA963646E0,
+    0xBD176620A501FBFF, 0xB650E5A93BC3D898,
+    0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE,
+    0x93BA47C980E98CDF, 0xC66F336C36B10137,
+    0xB8A8D9BBE123F017, 0xB80B0047445D4184,
+    0xE6D3102AD96CEC1D, 0xA60DC059157491E5,
+    0x9043EA1AC7E41392, 0x87C89837AD68DB2F,
+    0xB454E4A179DD1877, 0x29BABE4598C311FB,
+    0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A,
+    0x8CE2529E2734BB1D, 0x1899E4A65F58660C,
+    0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F,
+    0xDC21A1171D42645D, 0x76707543F4FA1F73,
+    0x899504AE72497EBA, 0x6A06494A791C53A8,
+    0xABFA45DA0EDBDE69, 0x0487DB9D17636892,
+    0xD6F8D7509292D603, 0x45A9D2845D3C42B6,
+    0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2,
+    0xA7F26836F282B732, 0x8E6CAC7768D7141E,
+    0xD1EF0244AF2364FF, 0x3207D795430CD926,
+    0x8335616AED761F1F, 0x7F44E6BD49E807B8,
+    0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6,
+    0xCD036837130890A1, 0x36DBA887C37A8C0F,
+    0x802221226BE55A64, 0xC2494954DA2C9789,
+    0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C,
+    0xC83553C5C8965D3D, 0x6F92829494E5ACC7,
+    0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9,
+    0x9C69A97284B578D7, 0xFF2A760414536EFB,
+    0xC38413CF25E2D70D, 0xFEF5138519684ABA,
+    0xF46518C2EF5B8CD1, 0x7EB258665FC25D69,
+    0x98BF2F79D5993802, 0xEF2F773FFBD97A61,
+    0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA,
+    0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38,
+    0x952AB45CFA97A0B2, 0xDD945A747BF26183,
+    0xBA756174393D88DF, 0x94F971119AEEF9E4,
+    0xE912B9D1478CEB17, 0x7A37CD5601AAB85D,
+    0x91ABB422CCB812EE, 0xAC62E055C10AB33A,
+    0xB616A12B7FE617AA, 0x577B986B314D6009,
+    0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B,
+    0x8E41ADE9FBEBC27D, 0x14588F13BE847307,
+    0xB1D219647AE6B31C, 0x596EB2D8AE258FC8,
+    0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB,
+    0x8AEC23D680043BEE, 0x25DE7BB9480D5854,
+    0xADA72CCC20054AE9, 0xAF561AA79A10AE6A,
+    0xD910F7FF28069DA4, 0x1B2BA1518094DA04,
+    0x87AA9AFF79042286, 0x90FB44D2F05D0842,
+    0xA99541BF57452B28, 0x353A1607AC744A53,
+    0xD3FA922F2D1675F2, 0x42889B8997915CE8,
+    0x847C9B5D7C2E09B7, 0x69956135FEBADA11,
+    0xA59BC234DB398C25, 0x43FAB9837E699095,
+    0xCF02B2C21207EF2E, 0x94F967E45E03F4BB,
+    0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5,
+    0xA1BA1BA79E1632DC, 0x6462D92A69731732,
+    0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE,
+    0xFCB2CB35E702AF78, 0x5CDA735244C3D43E,
+    0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7,
+    0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0,
+    0xF6C69A72A3989F5B, 0x8AAD549E57273D45,
+    0x9A3C2087A63F6399, 0x36AC54E2F678864B,
+    0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD,
+    0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5,
+    0x969EB7C47859E743, 0x9F644AE5A4B1B325,
+    0xBC4665B596706114, 0x873D5D9F0DDE1FEE,
+    0xEB57FF22FC0C7959, 0xA90CB506D155A7EA,
+    0x9316FF75DD87CBD8, 0x09A7F12442D588F2,
+    0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F,
+    0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA,
+    0x8FA475791A569D10, 0xF96E017D694487BC,
+    0xB38D92D760EC4455, 0x37C981DCC395A9AC,
+    0xE070F78D3927556A, 0x85BBE253F47B1417,
+    0x8C469AB843B89562, 0x93956D7478CCEC8E,
+    0xAF58416654A6BABB, 0x387AC8D1970027B2,
+    0xDB2E51BFE9D0696A, 0x06997B05FCC0319E,
+    0x88FCF317F22241E2, 0x441FECE3BDF81F03,
+    0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3,
+    0xD60B3BD56A5586F1, 0x8A71E223D8D3B074,
+    0x85C7056562757456, 0xF6872D5667844E49,
+    0xA738C6BEBB12D16C, 0xB428F8AC016561DB,
+    0xD106F86E69D785C7, 0xE13336D701BEBA52,
+    0x82A45B450226B39C, 0xECC0024661173473,
+    0xA34D721642B06084, 0x27F002D7F95D0190,
+    0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4,
+    0xFF290242C83396CE, 0x7E67047175A15271,
+    0x9F79A169BD203E41, 0x0F0062C6E984D386,
+    0xC75809C42C684DD1, 0x52C07B78A3E60868,
+    0xF92E0C3537826145, 0xA7709A56CCDF8A82,
+    0x9BBCC7A142B17CCB, 0x88A66076400BB691,
+    0xC2ABF989935DDBFE, 0x6ACFF893D00EA435,
+    0xF356F7EBF83552FE, 0x0583F6B8C4124D43,
+    0x98165AF37B2153DE, 0xC3727A337A8B704A,
+    0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C,
+    0xEDA2EE1C7064130C, 0x1162DEF06F79DF73,
+    0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8,
+    0xB9A74A0637CE2EE1, 0x6D953E2BD7173692,
+    0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437,
+    0x910AB1D4DB9914A0, 0x1D9C9892400A22A2,
+    0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B,
+    0xE2A0B5DC971F303A, 0x2E44AE64840FD61D,
+    0x8DA471A9DE737E24, 0x5CEAECFED289E5D2,
+    0xB10D8E1456105DAD, 0x7425A83E872C5F47,
+    0xDD50F1996B947518, 0xD12F124E28F77719,
+    0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F,
+    0xACE73CBFDC0BFB7B, 0x636CC64D1001550B,
+    0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E,
+    0x8714A775E3E95C78, 0x65ACFAEC34810A71,
+    0xA8D9D1535CE3B396, 0x7F1839A741A14D0D,
+    0xD31045A8341CA07C, 0x1EDE48111209A050,
+    0x83EA2B892091E44D, 0x934AED0AAB460432,
+    0xA4E4B66B68B65D60, 0xF81DA84D5617853F,
+    0xCE1DE40642E3F4B9, 0x36251260AB9D668E,
+    0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019,
+    0xA1075A24E4421730, 0xB24CF65B8612F81F,
+    0xC94930AE1D529CFC, 0xDEE033F26797B627,
+    0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1,
+    0x9D412E0806E88AA5, 0x8E1F289560EE864E,
+    0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2,
+    0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB,
+    0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29,
+    0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3,
+    0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0,
+    0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E,
+    0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1,
+    0xEA53DF5FD18D5513, 0x84C86189216DC5ED,
+    0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4,
+    0xB7118682DBB66A77, 0x3FBC8C33221DC2A1,
+    0xE4D5E82392A40515, 0x0FABAF3FEAA5334A,
+    0x8F05B1163BA6832D, 0x29CB4D87F2A7400E,
+    0xB2C71D5BCA9023F8, 0x743E20E9EF511012,
+    0xDF78E4B2BD342CF6, 0x914DA9246B255416,
+    0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E,
+    0xAE9672ABA3D0C320, 0xA184AC2473B529B1,
+    0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E,
+    0x8865899617FB1871, 0x7E2FA67C7A658892,
+    0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7,
+    0xD51EA6FA85785631, 0x552A74227F3EA565,
+    0x8533285C936B35DE, 0xD53A88958F87275F,
+    0xA67FF273B8460356, 0x8A892ABAF368F137,
+    0xD01FEF10A657842C, 0x2D2B7569B0432D85,
+    0x8213F56A67F6B29B, 0x9C3B29620E29FC73,
+    0xA298F2C501F45F42, 0x8349F3BA91B47B8F,
+    0xCB3F2F7642717713, 0x241C70A936219A73,
+    0xFE0EFB53D30DD4D7, 0xED238CD383AA0110,
+    0x9EC95D1463E8A506, 0xF4363804324A40AA,
+    0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5,
+    0xF81AA16FDC1B81DA, 0xDD94B7868E94050A,
+    0x9B10A4E5E9913128, 0xCA7CF2B4191C8326,
+    0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0,
+    0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC,
+    0x976E41088617CA01, 0xD5BE0503E085D813,
+    0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18,
+    0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E,
+    0x93E1AB8252F33B45, 0xCABB90E5C942B503,
+    0xB8DA1662E7B00A17, 0x3D6A751F3B936243,
+    0xE7109BFBA19C0C9D, 0x0CC512670A783AD4,
+    0x906A617D450187E2, 0x27FB2B80668B24C5,
+    0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6,
+    0xE1A63853BBD26451, 0x5E7873F8A0396973,
+    0x8D07E33455637EB2, 0xDB0B487B6423E1E8,
+    0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62,
+    0xDC5C5301C56B75F7, 0x7641A140CC7810FB,
+    0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D,
+    0xAC2820D9623BF429, 0x546345FA9FBDCD44,
+    0xD732290FBACAF133, 0xA97C177947AD4095,
+    0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D,
+    0xA81F301449EE8C70, 0x5C68F256BFFF5A74,
+    0xD226FC195C6A2F8C, 0x73832EEC6FFF3111,
+    0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB,
+    0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55,
+    0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB,
+    0x80444B5E7AA7CF85, 0x7980D163CF5B81B3,
+    0xA0555E361951C366, 0xD7E105BCC332621F,
+    0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7,
+    0xFA856334878FC150, 0xB14F98F6F0FEB951,
+    0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3,
+    0xC3B8358109E84F07, 0x0A862F80EC4700C8,
+    0xF4A642E14C6262C8, 0xCD27BB612758C0FA,
+    0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C,
+    0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3,
+    0xEEEA5D5004981478, 0x1858CCFCE06CAC74,
+    0x95527A5202DF0CCB, 0x0F37801E0C43EBC8,
+    0xBAA718E68396CFFD, 0xD30560258F54E6BA,
+    0xE950DF20247C83FD, 0x47C6B82EF32A2069,
+    0x91D28B7416CDD27E, 0x4CDC331D57FA5441,
+    0xB6472E511C81471D, 0xE0133FE4ADF8E952,
+    0xE3D8F9E563A198E5, 0x58180FDDD97723A6,
+    0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648
+};
+
+
+struct value128
+{
+  std::uint64_t low;
+  std::uint64_t high;
+};
+
+
+inline value128 full_multiplication(std::uint64_t a, std::uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+  auto r = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<std::uint64_t>(r), static_cast<std::uint64_t>(r >> 64)};
+#else
+  std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+  std::uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+  std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+  std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+  return {(mid << 32) | (ll & 0xFFFFFFFF), hh + (lh >> 32) + (hl >> 32) + (mid >> 32)};
+#endif
 }
 
 
-template <typename T> std::vector<T> split_keep_empty(std::string_view sv,
-    std::string_view token)
+inline int leading_zeros(std::uint64_t v)
 {
-  std::size_t start = 0;
-  auto i = sv.find(token);
-  std::vector<T> parts;
+#ifdef __GNUC__
+  return __builtin_clzll(v);
+#else
+  int n = 0;
+  for (; !(v & 0x8000000000000000); v <<= 1)
+    n++;
+  return n;
+#endif
+}
 
-  while (i != std::string_view::npos) {
-    parts.emplace_back(sv.substr(start, i - start));
-    start = i + token.size();
-    i = sv.find(token, start);
+
+// Significand without the implicit bit and the biased binary exponent
+struct adjusted_mantissa
+{
+  std::uint64_t mantissa = 0;
+  int power2 = 0;
+
+  bool operator==(const adjusted_mantissa& o) const
+  {
+    return mantissa == o.mantissa && power2 == o.power2;
   }
-  parts.emplace_back(sv.substr(start));
+};
 
-  return parts;
+
+// Correctly rounded w * 10^q for any w that is exact, the 128 bit product always carries
+// enough bits to decide the rounding (Mushtak and Lemire)
+template <typename T> adjusted_mantissa compute_float(std::int64_t q, std::uint64_t w)
+{
+  using format = float_format<T>;
+  adjusted_mantissa answer;
+  if (w == 0 || q < format::smallest_power_of_ten)
+    return answer;
+  if (q > format::largest_power_of_ten) {
+    answer.power2 = format::infinite_power;
+    return answer;
+  }
+
+  int lz = leading_zeros(w);
+  w <<= lz;
+  constexpr std::uint64_t precision_mask = ~std::uint64_t{0} >> (format::mantissa_bits + 3);
+  auto index = 2 * static_cast<std::size_t>(q - smallest_power_of_five);
+  auto product = full_multiplication(w, power_of_five_128[index]);
+  if ((product.high & precision_mask) == precision_mask) {
+    auto second = full_multiplication(w, power_of_five_128[index + 1]);
+    product.low += second.high;
+    if (second.high > product.low)
+      product.high++;
+  }
+
+  // floor(log2(10^q)) + 63 is ((152170 + 65536) * q) >> 16 + 63 for the whole range
+  int upper_bit = static_cast<int>(product.high >> 63);
+  int shift = upper_bit + 64 - format::mantissa_bits - 3;
+  answer.mantissa = product.high >> shift;
+  answer.power2 = static_cast<int>((((152170 + 65536) * q) >> 16) + 63 + upper_bit - lz -
+      format::minimum_exponent);
+
+  if (answer.power2 <= 0) {
+    // Subnormal, rounding may still carry into the smallest normal exponent
+    if (-answer.power2 + 1 >= 64)
+      return {};
+    answer.mantissa >>= -answer.power2 + 1;
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+    answer.power2 = answer.mantissa < (std::uint64_t{1} << format::mantissa_bits) ? 0 : 1;
+    return answer;
+  }
+
+  // Exactly halfway between two floats, only possible for small q, rounds to even
+  if (product.low <= 1 && q >= format::min_round_to_even && q <= format::max_round_to_even &&
+      (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == product.high)
+    answer.mantissa &= ~std::uint64_t{1};
+
+  answer.mantissa += answer.mantissa & 1;
+  answer.mantissa >>= 1;
+  if (answer.mantissa >= (std::uint64_t{2} << format::mantissa_bits)) {
+    answer.mantissa = std::uint64_t{1} << format::mantissa_bits;
+    answer.power2++;
+  }
+  answer.mantissa &= ~(std::uint64_t{1} << format::mantissa_bits);
+  if (answer.power2 >= format::infinite_power)
+    return {0, format::infinite_power};
+  return answer;
 }
 
 
-template <typename T> std::vector<T> split_ignore_empty(std::string_view sv,
-    std::string_view token)
+// Exact decimal arithmetic for the rare inputs the product cannot decide, the number is
+// scaled by powers of two until the significand bits can be read off (simple decimal
+// conversion as in Go's strconv)
+class big_decimal
 {
-  std::size_t start = 0;
-  auto i = sv.find(token);
-  std::vector<T> parts;
+public:
+  big_decimal(const char* first, const char* last, std::int64_t exponent)
+  {
+    bool dot = false;
+    for (; first != last; first++) {
+      if (*first == '.') {
+        dot = true;
+        dp_ = nd_;
+        continue;
+      }
+      if (*first == '0' && nd_ == 0) {
+        dp_--;
+        continue;
+      }
+      if (nd_ < max_digits)
+        d_[nd_++] = static_cast<std::uint8_t>(*first - '0');
+      else if (*first != '0')
+        trunc_ = true;
+    }
+    if (!dot)
+      dp_ = nd_;
+    exponent += dp_;
+    dp_ = static_cast<int>(std::clamp<std::int64_t>(exponent, -100000, 100000));
+    trim();
+  }
 
-  while (i != std::string_view::npos) {
-    if (auto len = i - start; len > 0)
-      parts.emplace_back(sv.substr(start, len));
-    start = i + token.size();
-    i = sv.find(token, start);
+
+  template <typename T> adjusted_mantissa to_float()
+  {
+    using format = float_format<T>;
+    constexpr int bias = format::minimum_exponent;
+    constexpr int max_biased = (1 << format::exponent_bits) - 1;
+    if (nd_ == 0 || dp_ < -330)
+      return {};
+    if (dp_ > 310)
+      return {0, format::infinite_power};
+
+    // Bring the value into [0.5, 1)
+    static constexpr int powtab[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    int exp = 0;
+    while (dp_ > 0) {
+      int n = dp_ >= 9 ? 27 : powtab[dp_];
+      shift(-n);
+      exp += n;
+    }
+    while (dp_ < 0 || (dp_ == 0 && d_[0] < 5)) {
+      int n = -dp_ >= 9 ? 27 : powtab[-dp_];
+      shift(n);
+      exp -= n;
+    }
+    exp--;
+
+    if (exp < bias + 1) {
+      int n = bias + 1 - exp;
+      shift(-n);
+      exp += n;
+    }
+    if (exp - bias >= max_biased)
+      return {0, format::infinite_power};
+
+    shift(1 + format::mantissa_bits);
+    auto mant = rounded_integer();
+    if (mant == std::uint64_t{2} << format::mantissa_bits) {
+      mant >>= 1;
+      exp++;
+      if (exp - bias >= max_biased)
+        return {0, format::infinite_power};
+    }
+    if (!(mant & (std::uint64_t{1} << format::mantissa_bits)))
+      exp = bias;
+    return {mant & ((std::uint64_t{1} << format::mantissa_bits) - 1), exp - bias};
   }
-  if (sv.size() - start > 0)
-    parts.emplace_back(sv.substr(start));
 
-  return parts;
+private:
+  static constexpr int max_digits = 800;
+  static constexpr int max_shift = 60;
+
+  void trim()
+  {
+    while (nd_ > 0 && d_[nd_ - 1] == 0)
+      nd_--;
+    if (nd_ == 0)
+      dp_ = 0;
+  }
+
+
+  void shift(int k)
+  {
+    if (nd_ == 0)
+      return;
+    for (; k > max_shift; k -= max_shift)
+      left_shift(max_shift);
+    for (; k < -max_shift; k += max_shift)
+      right_shift(max_shift);
+    if (k > 0)
+      left_shift(k);
+    else if (k < 0)
+      right_shift(-k);
+  }
+
+
+  // Multiplies by 2^k from the last digit on, 2^60 has 19 digits so that is the most the
+  // number can grow by
+  void left_shift(int k)
+  {
+    int w = nd_ + 18;
+    std::uint64_t n = 0;
+    for (int r = nd_ - 1; r >= 0; r--, w--) {
+      n += std::uint64_t{d_[r]} << k;
+      d_[w] = static_cast<std::uint8_t>(n % 10);
+      n /= 10;
+    }
+    for (; n > 0; w--) {
+      d_[w] = static_cast<std::uint8_t>(n % 10);
+      n /= 10;
+    }
+    int first = w + 1;
+    int count = nd_ + 19 - first;
+    dp_ += count - nd_;
+    std::memmove(d_, d_ + first, count);
+    nd_ = count;
+    if (nd_ > max_digits) {
+      for (int i = max_digits; i < nd_; i++)
+        trunc_ = trunc_ || d_[i] != 0;
+      nd_ = max_digits;
+    }
+    trim();
+  }
+
+
+  // Divides by 2^k from the first digit on
+  void right_shift(int k)
+  {
+    int r = 0;
+    int w = 0;
+    std::uint64_t n = 0;
+    while (!(n >> k)) {
+      if (r >= nd_) {
+        if (n == 0) {
+          nd_ = 0;
+          return;
+        }
+        while (!(n >> k)) {
+          n *= 10;
+          r++;
+        }
+        break;
+      }
+      n = n * 10 + d_[r++];
+    }
+    dp_ -= r - 1;
+
+    const std::uint64_t mask = (std::uint64_t{1} << k) - 1;
+    for (; r < nd_; r++) {
+      d_[w++] = static_cast<std::uint8_t>(n >> k);
+      n = (n & mask) * 10 + d_[r];
+    }
+    while (n > 0) {
+      auto digit = static_cast<std::uint8_t>(n >> k);
+      if (w < max_digits)
+        d_[w++] = digit;
+      else if (digit > 0)
+        trunc_ = true;
+      n = (n & mask) * 10;
+    }
+    nd_ = w;
+    trim();
+  }
+
+
+  bool should_round_up(int n) const
+  {
+    if (n < 0 || n >= nd_)
+      return false;
+    if (d_[n] == 5 && n + 1 == nd_)
+      return trunc_ || (n > 0 && d_[n - 1] % 2 == 1);
+    return d_[n] >= 5;
+  }
+
+
+  std::uint64_t rounded_integer() const
+  {
+    if (dp_ > 20)
+      return ~std::uint64_t{0};
+    std::uint64_t n = 0;
+    int i = 0;
+    for (; i < dp_ && i < nd_; i++)
+      n = n * 10 + d_[i];
+    for (; i < dp_; i++)
+      n *= 10;
+    if (should_round_up(dp_))
+      n++;
+    return n;
+  }
+
+  std::uint8_t d_[max_digits + 19];
+  int nd_ = 0;
+  int dp_ = 0;
+  bool trunc_ = false;
+};
+
+
+// What std::from_chars_result holds, without depending on <charconv>
+struct scan_result
+{
+  const char* ptr;
+  std::errc ec;
+};
+
+
+template <typename T> scan_result parse_inf_nan(const char* first, const char* p,
+    const char* last, bool negative, T& value)
+{
+  auto matches = [&](std::string_view word) {
+    if (static_cast<std::size_t>(last - p) < word.size())
+      return false;
+    for (std::size_t i = 0; i < word.size(); i++) {
+      if ((p[i] | 0x20) != word[i])
+        return false;
+    }
+    return true;
+  };
+
+  if (matches("nan")) {
+    p += 3;
+    if (p != last && *p == '(') {
+      const char* q = p + 1;
+      auto is_word = [](char c) {
+        return static_cast<unsigned char>(c - '0') <= 9 ||
+            static_cast<unsigned char>((c | 0x20) - 'a') < 26 || c == '_';
+      };
+      while (q != last && is_word(*q))
+        q++;
+      if (q != last && *q == ')')
+        p = q + 1;
+    }
+    value = negative ? -std::numeric_limits<T>::quiet_NaN() :
+        std::numeric_limits<T>::quiet_NaN();
+    return {p, std::errc{}};
+  }
+  if (matches("inf")) {
+    p += matches("infinity") ? 8 : 3;
+    value = negative ? -std::numeric_limits<T>::infinity() :
+        std::numeric_limits<T>::infinity();
+    return {p, std::errc{}};
+  }
+  return {first, std::errc::invalid_argument};
 }
 
 
-template <typename T> std::vector<T> split_chars(std::string_view sv,
-    std::size_t char_count, std::size_t skip = 0)
+// Same grammar and results as std::from_chars with chars_format::general, plus an optional
+// leading '+'; value is left alone on errors and when the result would be out of range
+template <typename T> scan_result parse_float(const char* first, const char* last, T& value)
 {
-  if (char_count == 0)
-    return std::vector<T>{};
+  using format = float_format<T>;
+  auto is_digit = [](char c) { return static_cast<unsigned char>(c - '0') <= 9; };
+
+  const char* p = first;
+  bool negative = false;
+  if (p != last && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    p++;
+  }
+  if (p != last && ((*p | 0x20) == 'i' || (*p | 0x20) == 'n'))
+    return parse_inf_nan(first, p, last, negative, value);
+
+  const char* integer = p;
+  std::uint64_t w = 0;
+  for (; p != last && is_digit(*p); p++)
+    w = w * 10 + static_cast<unsigned>(*p - '0');
+  const char* integer_end = p;
+  const char* fraction = p;
+  const char* fraction_end = p;
+  if (p != last && *p == '.') {
+    fraction = ++p;
+    for (; p != last && is_digit(*p); p++)
+      w = w * 10 + static_cast<unsigned>(*p - '0');
+    fraction_end = p;
+  }
+  const char* digits_end = p;
+  std::int64_t digit_count = (integer_end - integer) + (fraction_end - fraction);
+  if (digit_count == 0)
+    return {first, std::errc::invalid_argument};
+
+  std::int64_t exp_number = 0;
+  if (p != last && (*p | 0x20) == 'e') {
+    const char* e = p + 1;
+    bool negative_exponent = false;
+    if (e != last && (*e == '-' || *e == '+')) {
+      negative_exponent = *e == '-';
+      e++;
+    }
+    if (e != last && is_digit(*e)) {
+      for (; e != last && is_digit(*e); e++) {
+        if (exp_number < 0x10000000)
+          exp_number = exp_number * 10 + (*e - '0');
+      }
+      if (negative_exponent)
+        exp_number = -exp_number;
+      p = e;
+    }
+  }
+  std::int64_t q = exp_number - (fraction_end - fraction);
+
+  // Only the first 19 significant digits fit, the value lies in [w, w + 1) * 10^q
+  bool truncated = false;
+  if (digit_count > 19) {
+    for (const char* z = integer; z != digits_end && (*z == '0' || *z == '.'); z++)
+      digit_count -= *z == '0';
+    if (digit_count > 19) {
+      truncated = true;
+      constexpr std::uint64_t min_nineteen_digits = 1000000000000000000;
+      w = 0;
+      const char* z = integer;
+      for (; w < min_nineteen_digits && z != integer_end; z++)
+        w = w * 10 + static_cast<unsigned>(*z - '0');
+      if (w >= min_nineteen_digits) {
+        q = exp_number + (integer_end - z);
+      }
+      else {
+        for (z = fraction; w < min_nineteen_digits && z != fraction_end; z++)
+          w = w * 10 + static_cast<unsigned>(*z - '0');
+        q = exp_number - (z - fraction);
+      }
+    }
+  }
 
-  std::vector<T> v;
-  auto size = sv.size();
-  std::size_t i = 0;
-  while (i < size) {
-    v.emplace_back(sv.substr(i, char_count));
-    i += char_count + skip;
+  if (w == 0) {
+    value = negative ? -T{0} : T{0};
+    return {p, std::errc{}};
   }
 
-  return v;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  // Both the significand and the power of ten are exact, a single operation rounds once
+  if (!truncated && q >= -format::max_exact_power && q <= format::max_exact_power &&
+      w <= format::max_exact_mantissa) {
+    auto v = static_cast<T>(w);
+    v = q < 0 ? v / format::exact_powers[-q] : v * format::exact_powers[q];
+    value = negative ? -v : v;
+    return {p, std::errc{}};
+  }
+#endif
+
+  auto answer = compute_float<T>(q, w);
+  if (truncated && !(answer == compute_float<T>(q, w + 1)))
+    answer = big_decimal(integer, digits_end, exp_number).template to_float<T>();
+  if (answer.power2 == format::infinite_power || (answer.power2 == 0 && answer.mantissa == 0))
+    return {p, std::errc::result_out_of_range};
+
+  using bits_type = typename format::bits_type;
+  auto bits = static_cast<bits_type>(answer.mantissa |
+      (static_cast<std::uint64_t>(answer.power2) << format::mantissa_bits) |
+      (static_cast<std::uint64_t>(negative) << (sizeof(T) * 8 - 1)));
+  std::memcpy(&value, &bits, sizeof(value));
+  return {p, std::errc{}};
 }
 
 
-template <typename T> std::tuple<T, T> split_first(std::string_view sv,
-    std::string_view token)
+template <typename T> T parse_float(std::string_view sv)
 {
-  if (auto i = sv.find(token); i != std::string_view::npos) {
-    return {T{sv.substr(0, i)}, T{sv.substr(i+token.size())}};
+  T value{};
+  parse_float(sv.data(), sv.data() + sv.size(), value);
+  return value;
+}
+
+
+#ifdef NONSTD_STRING_UTILS_CHARCONV
+  template <typename T> T parse_number(std::string_view sv, int base = 10)
+  {
+    T value{};
+    std::from_chars(sv.data(), sv.data() + sv.size(), value, base);
+    return value;
   }
-  return {T{sv}, T{}};
+
+
+  // Base 10 integer parsing with the same results as std::from_chars, up to 19 digits are
+  // accumulated without overflow checks and only longer numbers go through from_chars
+  template <typename T> std::from_chars_result parse_decimal(const char* first,
+      const char* last, T& value)
+  {
+    const char* p = first;
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      if (p != last && *p == '-') {
+        negative = true;
+        p++;
+      }
+    }
+
+    const char* digits = p;
+    const char* stop = last - p > 19 ? p + 19 : last;
+    std::uint64_t u = 0;
+    for (; p != stop; p++) {
+      auto d = static_cast<unsigned char>(*p - '0');
+      if (d > 9)
+        break;
+      u = u * 10 + d;
+    }
+    if (p == digits)
+      return {first, std::errc::invalid_argument};
+    if (p != last && static_cast<unsigned char>(*p - '0') <= 9)
+      return std::from_chars(first, last, value);
+
+    using U = std::make_unsigned_t<T>;
+    auto limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+    if (u > limit)
+      return {p, std::errc::result_out_of_range};
+    value = static_cast<T>(negative ? static_cast<U>(0 - u) : static_cast<U>(u));
+    return {p, std::errc{}};
+  }
+
+
+  // Parses the fields in place while scanning, without splitting into views first
+  template <typename T, typename OutputIt> parse_result parse_delimited(std::string_view sv,
+      char delimiter, OutputIt out)
+  {
+    parse_result result;
+    if (sv.empty())
+      return result;
+
+    const char* first = sv.data();
+    const char* last = sv.data() + sv.size();
+    while (true) {
+      T value{};
+      auto [ptr, ec] = [&] {
+        if constexpr (std::is_floating_point_v<T>)
+          return parse_float(first, last, value);
+        else
+          return parse_decimal(first, last, value);
+      }();
+      if (ec == std::errc{} && ptr != last && *ptr != delimiter)
+        ec = std::errc::invalid_argument;
+      if (ec != std::errc{}) {
+        result.field = std::string_view(first, std::find(first, last, delimiter) - first);
+        result.ec = ec;
+        return result;
+      }
+      *out++ = value;
+      result.count++;
+      if (ptr == last)
+        return result;
+      first = ptr + 1;
+    }
+  }
+#endif  // NONSTD_STRING_UTILS_CHARCONV
+
+
+inline simd_level detect_simd_level()
+{
+#ifdef NONSTD_STRING_UTILS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512bw"))
+    return simd_level::avx512bw;
+  if (__builtin_cpu_supports("avx2"))
+    return simd_level::avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return simd_level::sse2;
+#endif
+  return simd_level::scalar;
 }
 
 
-template <typename T> std::tuple<T, T> split_last(std::string_view sv,
-    std::string_view token)
+inline simd_level initial_simd_level()
 {
-  if (auto i = sv.rfind(token); i != std::string_view::npos) {
-    return {T{sv.substr(0, i)}, T{sv.substr(i+token.size())}};
+  auto level = detect_simd_level();
+  if (const char* env = std::getenv("NONSTD_STRING_UTILS_SIMD"); env != nullptr) {
+    auto forced = std::string_view{env};
+    if (forced == "scalar")
+      return simd_level::scalar;
+    if (forced == "sse2")
+      return std::min(level, simd_level::sse2);
+    if (forced == "avx2")
+      return std::min(level, simd_level::avx2);
+    if (forced == "avx512bw")
+      return std::min(level, simd_level::avx512bw);
   }
-  return {T{sv}, T{}};
+  return level;
 }
 
 
-template <typename T> T before_first(std::string_view sv, std::string_view token)
+inline std::atomic<simd_level>& active_simd_level()
 {
-  if (auto i = sv.find(token); i != std::string_view::npos) {
-    return T{sv.substr(0, i)};
-  }
-  return T{};
+  static std::atomic<simd_level> level{initial_simd_level()};
+  return level;
 }
 
 
-template <typename T> T before_last(std::string_view sv, std::string_view token)
+inline simd_level simd()
 {
-  if (auto i = sv.rfind(token); i != std::string_view::npos) {
-    return T{sv.substr(0, i)};
-  }
-  return T{};
+  return active_simd_level().load(std::memory_order_relaxed);
+}
+
+
+// Vectorized kernels, each one processes whole blocks starting at i and leaves the rest
+// to the next narrower tier
+//
+
+// Largest set of bytes the any-of kernels compare against
+inline constexpr std::size_t max_any_of = 8;
+
+
+// Compares a token known at compile time byte by byte without a loop, two byte tokens become a
+// single 16 bit compare
+template <char... Ds, std::size_t... I> bool equal_constant(const char* p,
+    std::index_sequence<I...>)
+{
+  return ((p[I] == Ds) && ...);
 }
 
 
-template <typename T> T after_first(std::string_view sv, std::string_view token)
+template <char... Ds> bool equal_constant(const char* p)
 {
-  if (auto i = sv.find(token); i != std::string_view::npos) {
-    return T{sv.substr(i + token.size())};
+  return equal_constant<Ds...>(p, std::make_index_sequence<sizeof...(Ds)>{});
+}
+
+
+template <char... Ds> inline constexpr char first_of = std::array<char, sizeof...(Ds)>{Ds...}[0];
+template <char... Ds> inline constexpr char last_of =
+    std::array<char, sizeof...(Ds)>{Ds...}[sizeof...(Ds) - 1];
+
+
+#ifdef NONSTD_STRING_UTILS_X86
+  template <typename F> NONSTD_STRING_UTILS_TARGET("avx512bw")
+  bool for_each_char_avx512bw(const char* p, std::size_t size, char c, std::size_t& i, F& func)
+  {
+    const auto needle = _mm512_set1_epi8(c);
+    for (; i + 64 <= size; i += 64) {
+      auto block = _mm512_loadu_si512(p + i);
+      auto mask = static_cast<std::uint64_t>(_mm512_cmpeq_epi8_mask(block, needle));
+      for (; mask != 0; mask &= mask - 1) {
+        if (!func(i + __builtin_ctzll(mask)))
+          return false;
+      }
+    }
+    return true;
   }
-  return T{};
+
+
+  template <typename F> NONSTD_STRING_UTILS_TARGET("avx2")
+  bool for_each_char_avx2(const char* p, std::size_t size, char c, std::size_t& i, F& func)
+  {
+    const auto needle = _mm256_set1_epi8(c);
+    for (; i + 32 <= size; i += 32) {
+      auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+      auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+      for (; mask != 0; mask &= mask - 1) {
+        if (!func(i + __builtin_ctz(mask)))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  template <typename F> NONSTD_STRING_UTILS_TARGET("sse2")
+  bool for_each_char_sse2(const char* p, std::size_t size, char c, std::size_t& i, F& func)
+  {
+    const auto needle = _mm_set1_epi8(c);
+    for (; i + 16 <= size; i += 16) {
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+      auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+      for (; mask != 0; mask &= mask - 1) {
+        if (!func(i + __builtin_ctz(mask)))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  // Bit j of the result is set when p[j] == c, for a whole block of 64 bytes
+  NONSTD_STRING_UTILS_TARGET("avx512bw")
+  inline std::uint64_t char_mask_avx512bw(const char* p, char c)
+  {
+    auto block = _mm512_loadu_si512(p);
+    return static_cast<std::uint64_t>(_mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8(c)));
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("avx2")
+  inline std::uint64_t char_mask_avx2(const char* p, char c)
+  {
+    const auto needle = _mm256_set1_epi8(c);
+    auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    auto lo_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    auto hi_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return lo_mask | static_cast<std::uint64_t>(hi_mask) << 32;
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("sse2")
+  inline std::uint64_t char_mask_sse2(const char* p, char c)
+  {
+    const auto needle = _mm_set1_epi8(c);
+    std::uint64_t mask = 0;
+    for (int j = 0; j < 64; j += 16) {
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j));
+      auto m = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+      mask |= static_cast<std::uint64_t>(m) << j;
+    }
+    return mask;
+  }
+
+
+  // Like for_each_char for up to max_any_of different bytes
+  template <typename F> NONSTD_STRING_UTILS_TARGET("avx512bw")
+  bool for_each_any_of_avx512bw(const char* p, std::size_t size, const char* set, std::size_t n,
+      std::size_t& i, F& func)
+  {
+    __m512i needles[max_any_of];
+    for (std::size_t k = 0; k < n; k++)
+      needles[k] = _mm512_set1_epi8(set[k]);
+    for (; i + 64 <= size; i += 64) {
+      auto block = _mm512_loadu_si512(p + i);
+      std::uint64_t mask = 0;
+      for (std::size_t k = 0; k < n; k++)
+        mask |= _mm512_cmpeq_epi8_mask(block, needles[k]);
+      for (; mask != 0; mask &= mask - 1) {
+        if (!func(i + __builtin_ctzll(mask)))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  template <typename F> NONSTD_STRING_UTILS_TARGET("avx2")
+  bool for_each_any_of_avx2(const char* p, std::size_t size, const char* set, std::size_t n,
+      std::size_t& i, F& func)
+  {
+    __m256i needles[max_any_of];
+    for (std::size_t k = 0; k < n; k++)
+      needles[k] = _mm256_set1_epi8(set[k]);
+    for (; i + 32 <= size; i += 32) {
+      auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+      auto hits = _mm256_cmpeq_epi8(block, needles[0]);
+      for (std::size_t k = 1; k < n; k++)
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[k]));
+      auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+      for (; mask != 0; mask &= mask - 1) {
+        if (!func(i + __builtin_ctz(mask)))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  template <typename F> NONSTD_STRING_UTILS_TARGET("sse2")
+  bool for_each_any_of_sse2(const char* p, std::size_t size, const char* set, std::size_t n,
+      std::size_t& i, F& func)
+  {
+    __m128i needles[max_any_of];
+    for (std::size_t k = 0; k < n; k++)
+      needles[k] = _mm_set1_epi8(set[k]);
+    for (; i + 16 <= size; i += 16) {
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+      auto hits = _mm_cmpeq_epi8(block, needles[0]);
+      for (std::size_t k = 1; k < n; k++)
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[k]));
+      auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+      for (; mask != 0; mask &= mask - 1) {
+        if (!func(i + __builtin_ctz(mask)))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  // Substring search filtering candidates by the token bytes at offsets a and b, usually
+  // the first and the last one, the token has at least two bytes
+  NONSTD_STRING_UTILS_TARGET("avx512bw")
+  inline std::size_t find_avx512bw(const char* p, std::size_t size, const char* t, std::size_t m,
+      std::size_t a, std::size_t b, std::size_t& i)
+  {
+    const auto first = _mm512_set1_epi8(t[a]);
+    const auto last = _mm512_set1_epi8(t[b]);
+    for (; i + m - 1 + 64 <= size; i += 64) {
+      auto mask = static_cast<std::uint64_t>(
+          _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i + a), first) &
+          _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i + b), last));
+      for (; mask != 0; mask &= mask - 1) {
+        auto j = i + __builtin_ctzll(mask);
+        if (std::memcmp(p + j, t, m) == 0)
+          return j;
+      }
+    }
+    return std::string_view::npos;
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("avx2")
+  inline std::size_t find_avx2(const char* p, std::size_t size, const char* t, std::size_t m,
+      std::size_t a, std::size_t b, std::size_t& i)
+  {
+    const auto first = _mm256_set1_epi8(t[a]);
+    const auto last = _mm256_set1_epi8(t[b]);
+    for (; i + m - 1 + 32 <= size; i += 32) {
+      auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + a));
+      auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + b));
+      auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(x, first), _mm256_cmpeq_epi8(y, last))));
+      for (; mask != 0; mask &= mask - 1) {
+        auto j = i + __builtin_ctz(mask);
+        if (std::memcmp(p + j, t, m) == 0)
+          return j;
+      }
+    }
+    return std::string_view::npos;
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("sse2")
+  inline std::size_t find_sse2(const char* p, std::size_t size, const char* t, std::size_t m,
+      std::size_t a, std::size_t b, std::size_t& i)
+  {
+    const auto first = _mm_set1_epi8(t[a]);
+    const auto last = _mm_set1_epi8(t[b]);
+    for (; i + m - 1 + 16 <= size; i += 16) {
+      auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + a));
+      auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + b));
+      auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(x, first), _mm_cmpeq_epi8(y, last))));
+      for (; mask != 0; mask &= mask - 1) {
+        auto j = i + __builtin_ctz(mask);
+        if (std::memcmp(p + j, t, m) == 0)
+          return j;
+      }
+    }
+    return std::string_view::npos;
+  }
+
+
+  // All positions of a token known at compile time, candidates are filtered by its first and
+  // last byte. Only tokens of more than two bytes need the bytes in between compared
+  template <char... Ds, typename F> NONSTD_STRING_UTILS_TARGET("avx512bw")
+  bool for_each_constant_avx512bw(const char* p, std::size_t size, std::size_t& i, F& func)
+  {
+    constexpr std::size_t m = sizeof...(Ds);
+    const auto first = _mm512_set1_epi8(first_of<Ds...>);
+    const auto last = _mm512_set1_epi8(last_of<Ds...>);
+    for (; i + m - 1 + 64 <= size; i += 64) {
+      auto mask = static_cast<std::uint64_t>(
+          _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i), first) &
+          _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i + m - 1), last));
+      for (; mask != 0; mask &= mask - 1) {
+        auto j = i + __builtin_ctzll(mask);
+        if ((m <= 2 || equal_constant<Ds...>(p + j)) && !func(j))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  template <char... Ds, typename F> NONSTD_STRING_UTILS_TARGET("avx2")
+  bool for_each_constant_avx2(const char* p, std::size_t size, std::size_t& i, F& func)
+  {
+    constexpr std::size_t m = sizeof...(Ds);
+    const auto first = _mm256_set1_epi8(first_of<Ds...>);
+    const auto last = _mm256_set1_epi8(last_of<Ds...>);
+    for (; i + m - 1 + 32 <= size; i += 32) {
+      auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+      auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + m - 1));
+      auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(x, first), _mm256_cmpeq_epi8(y, last))));
+      for (; mask != 0; mask &= mask - 1) {
+        auto j = i + __builtin_ctz(mask);
+        if ((m <= 2 || equal_constant<Ds...>(p + j)) && !func(j))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  template <char... Ds, typename F> NONSTD_STRING_UTILS_TARGET("sse2")
+  bool for_each_constant_sse2(const char* p, std::size_t size, std::size_t& i, F& func)
+  {
+    constexpr std::size_t m = sizeof...(Ds);
+    const auto first = _mm_set1_epi8(first_of<Ds...>);
+    const auto last = _mm_set1_epi8(last_of<Ds...>);
+    for (; i + m - 1 + 16 <= size; i += 16) {
+      auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+      auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + m - 1));
+      auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(x, first), _mm_cmpeq_epi8(y, last))));
+      for (; mask != 0; mask &= mask - 1) {
+        auto j = i + __builtin_ctz(mask);
+        if ((m <= 2 || equal_constant<Ds...>(p + j)) && !func(j))
+          return false;
+      }
+    }
+    return true;
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("avx512bw")
+  inline bool equal_avx512bw(const char* a, const char* b, std::size_t size, std::size_t& i)
+  {
+    for (; i + 64 <= size; i += 64) {
+      if (_mm512_cmpneq_epi8_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)) != 0)
+        return false;
+    }
+    return true;
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("avx2")
+  inline bool equal_avx2(const char* a, const char* b, std::size_t size, std::size_t& i)
+  {
+    for (; i + 32 <= size; i += 32) {
+      auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != -1)
+        return false;
+    }
+    return true;
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("sse2")
+  inline bool equal_sse2(const char* a, const char* b, std::size_t size, std::size_t& i)
+  {
+    for (; i + 16 <= size; i += 16) {
+      auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+      auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+        return false;
+    }
+    return true;
+  }
+
+
+  // Flips the case bit of every byte in [first, first + 25], i.e. 'a' for upper and 'A'
+  // for lower case, bytes >= 0x80 compare as negative and are left alone
+  NONSTD_STRING_UTILS_TARGET("avx512bw")
+  inline void convert_case_avx512bw(const char* src, char* dst, std::size_t size, char first,
+      std::size_t& i)
+  {
+    const auto lo = _mm512_set1_epi8(static_cast<char>(first - 1));
+    const auto hi = _mm512_set1_epi8(static_cast<char>(first + 26));
+    const auto flip = _mm512_set1_epi8(0x20);
+    for (; i + 64 <= size; i += 64) {
+      auto x = _mm512_loadu_si512(src + i);
+      auto in = _mm512_cmpgt_epi8_mask(x, lo) & _mm512_cmplt_epi8_mask(x, hi);
+      _mm512_storeu_si512(dst + i, _mm512_xor_si512(x, _mm512_maskz_mov_epi8(in, flip)));
+    }
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("avx2")
+  inline void convert_case_avx2(const char* src, char* dst, std::size_t size, char first,
+      std::size_t& i)
+  {
+    const auto lo = _mm256_set1_epi8(static_cast<char>(first - 1));
+    const auto hi = _mm256_set1_epi8(static_cast<char>(first + 26));
+    const auto flip = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= size; i += 32) {
+      auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      auto in = _mm256_and_si256(_mm256_cmpgt_epi8(x, lo), _mm256_cmpgt_epi8(hi, x));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+          _mm256_xor_si256(x, _mm256_and_si256(in, flip)));
+    }
+  }
+
+
+  NONSTD_STRING_UTILS_TARGET("sse2")
+  inline void convert_case_sse2(const char* src, char* dst, std::size_t size, char first,
+      std::size_t& i)
+  {
+    const auto lo = _mm_set1_epi8(static_cast<char>(first - 1));
+    const auto hi = _mm_set1_epi8(static_cast<char>(first + 26));
+    const auto flip = _mm_set1_epi8(0x20);
+    for (; i + 16 <= size; i += 16) {
+      auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      auto in = _mm_and_si128(_mm_cmpgt_epi8(x, lo), _mm_cmplt_epi8(x, hi));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+          _mm_xor_si128(x, _mm_and_si128(in, flip)));
+    }
+  }
+#endif  // NONSTD_STRING_UTILS_X86
+
+
+// Bit j of the result is the xor of bits 0 to j, turns a mask of quotes into a mask of
+// the bytes from an opening quote up to its closing one
+inline std::uint64_t prefix_xor(std::uint64_t mask)
+{
+  for (int shift = 1; shift < 64; shift *= 2)
+    mask ^= mask << shift;
+  return mask;
+}
+
+
+// Index of the lowest set bit, mask must not be 0
+inline std::size_t lowest_bit(std::uint64_t mask)
+{
+#ifdef __GNUC__
+  return static_cast<std::size_t>(__builtin_ctzll(mask));
+#else
+  std::size_t j = 0;
+  for (; (mask & 1) == 0; mask >>= 1)
+    j++;
+  return j;
+#endif
+}
+
+
+// Bit j is set when p[j] == c, for the first 64 bytes or size if it is less
+inline std::uint64_t char_mask(const char* p, std::size_t size, char c)
+{
+  if (size >= 64) {
+    switch (simd()) {
+#ifdef NONSTD_STRING_UTILS_X86
+      case simd_level::avx512bw:
+        return char_mask_avx512bw(p, c);
+      case simd_level::avx2:
+        return char_mask_avx2(p, c);
+      case simd_level::sse2:
+        return char_mask_sse2(p, c);
+#endif
+      default:
+        break;
+    }
+  }
+  std::uint64_t mask = 0;
+  std::size_t j = 0;
+#ifdef NONSTD_STRING_UTILS_LITTLE_ENDIAN
+  // Exact zero byte test on the word xor c, the top bits are then gathered with a multiply
+  constexpr std::uint64_t low7 = 0x7f7f7f7f7f7f7f7f;
+  const auto pattern = 0x0101010101010101 *
+      static_cast<std::uint64_t>(static_cast<unsigned char>(c));
+  for (; j + 8 <= std::min<std::size_t>(size, 64); j += 8) {
+    std::uint64_t x;
+    std::memcpy(&x, p + j, 8);
+    x ^= pattern;
+    auto zero = ~(((x & low7) + low7) | x | low7);
+    mask |= ((zero >> 7) * 0x0102040810204080) >> 56 << j;
+  }
+#endif
+  for (; j < std::min<std::size_t>(size, 64); j++)
+    mask |= static_cast<std::uint64_t>(p[j] == c) << j;
+  return mask;
+}
+
+
+// Calls func with the position of every occurrence of c, stops as soon as func returns false
+template <typename F> bool for_each_char(std::string_view sv, char c, F func)
+{
+  const char* p = sv.data();
+  std::size_t size = sv.size();
+  std::size_t i = 0;
+
+  switch (simd()) {
+#ifdef NONSTD_STRING_UTILS_X86
+    case simd_level::avx512bw:
+      if (!for_each_char_avx512bw(p, size, c, i, func))
+        return false;
+      [[fallthrough]];
+    case simd_level::avx2:
+      if (!for_each_char_avx2(p, size, c, i, func))
+        return false;
+      [[fallthrough]];
+    case simd_level::sse2:
+      if (!for_each_char_sse2(p, size, c, i, func))
+        return false;
+      [[fallthrough]];
+#endif
+    default:
+      break;
+  }
+  for (; i < size; i++) {
+    if (p[i] == c && !func(i))
+      return false;
+  }
+
+  return true;
+}
+
+
+// Calls func with the position of every occurrence of a token of at least two bytes known at
+// compile time, overlapping ones included; stops as soon as func returns false
+template <char... Ds, typename F> bool for_each_constant(std::string_view sv, F func)
+{
+  constexpr std::size_t m = sizeof...(Ds);
+  const char* p = sv.data();
+  std::size_t size = sv.size();
+  std::size_t i = 0;
+
+  switch (simd()) {
+#ifdef NONSTD_STRING_UTILS_X86
+    case simd_level::avx512bw:
+      if (!for_each_constant_avx512bw<Ds...>(p, size, i, func))
+        return false;
+      [[fallthrough]];
+    case simd_level::avx2:
+      if (!for_each_constant_avx2<Ds...>(p, size, i, func))
+        return false;
+      [[fallthrough]];
+    case simd_level::sse2:
+      if (!for_each_constant_sse2<Ds...>(p, size, i, func))
+        return false;
+      [[fallthrough]];
+#endif
+    default:
+      break;
+  }
+  while (i + m <= size) {
+    auto q = static_cast<const char*>(std::memchr(p + i, first_of<Ds...>, size - m + 1 - i));
+    if (q == nullptr)
+      break;
+    i = static_cast<std::size_t>(q - p);
+    if (equal_constant<Ds...>(q) && !func(i))
+      return false;
+    i++;
+  }
+
+  return true;
+}
+
+
+// Vectorized search for tokens of at least two bytes, see the find kernels for a and b
+inline std::size_t find_filtered(std::string_view sv, std::string_view token, std::size_t pos,
+    [[maybe_unused]] std::size_t a, [[maybe_unused]] std::size_t b)
+{
+  const char* p = sv.data();
+  std::size_t size = sv.size();
+  std::size_t i = pos;
+  [[maybe_unused]] std::size_t j = std::string_view::npos;
+  [[maybe_unused]] const char* t = token.data();
+  [[maybe_unused]] std::size_t m = token.size();
+
+  switch (simd()) {
+#ifdef NONSTD_STRING_UTILS_X86
+    case simd_level::avx512bw:
+      if (j = find_avx512bw(p, size, t, m, a, b, i); j != std::string_view::npos)
+        return j;
+      [[fallthrough]];
+    case simd_level::avx2:
+      if (j = find_avx2(p, size, t, m, a, b, i); j != std::string_view::npos)
+        return j;
+      [[fallthrough]];
+    case simd_level::sse2:
+      if (j = find_sse2(p, size, t, m, a, b, i); j != std::string_view::npos)
+        return j;
+      [[fallthrough]];
+#endif
+    default:
+      break;
+  }
+
+  return sv.find(token, i);
+}
+
+
+inline std::size_t find(std::string_view sv, std::string_view token, std::size_t pos = 0)
+{
+  if (token.empty() || pos > sv.size())
+    return sv.find(token, pos);
+
+  if (token.size() == 1) {
+    auto result = std::string_view::npos;
+    for_each_char(sv.substr(pos), token.front(), [&](std::size_t i) {
+      result = pos + i;
+      return false;
+    });
+    return result;
+  }
+
+  return find_filtered(sv, token, pos, 0, token.size() - 1);
+}
+
+
+inline std::size_t rfind(std::string_view sv, std::string_view token)
+{
+  return sv.rfind(token);
+}
+
+
+// Calls func with the position of every byte that is in set, stops as soon as func returns
+// false; sets larger than max_any_of are only searched by the scalar code
+template <typename F> bool for_each_any_of(std::string_view sv, std::string_view set, F func)
+{
+  if (set.empty())
+    return true;
+  if (set.size() == 1)
+    return for_each_char(sv, set.front(), func);
+
+  const char* p = sv.data();
+  std::size_t size = sv.size();
+  std::size_t i = 0;
+
+  switch (set.size() <= max_any_of ? simd() : simd_level::scalar) {
+#ifdef NONSTD_STRING_UTILS_X86
+    case simd_level::avx512bw:
+      if (!for_each_any_of_avx512bw(p, size, set.data(), set.size(), i, func))
+        return false;
+      [[fallthrough]];
+    case simd_level::avx2:
+      if (!for_each_any_of_avx2(p, size, set.data(), set.size(), i, func))
+        return false;
+      [[fallthrough]];
+    case simd_level::sse2:
+      if (!for_each_any_of_sse2(p, size, set.data(), set.size(), i, func))
+        return false;
+      [[fallthrough]];
+#endif
+    default:
+      break;
+  }
+  std::array<bool, 256> in_set{};
+  for (char c : set)
+    in_set[static_cast<unsigned char>(c)] = true;
+  for (; i < size; i++) {
+    if (in_set[static_cast<unsigned char>(p[i])] && !func(i))
+      return false;
+  }
+
+  return true;
+}
+
+
+inline std::size_t find_first_of(std::string_view sv, std::string_view set, std::size_t pos = 0)
+{
+  auto result = std::string_view::npos;
+  if (pos < sv.size()) {
+    for_each_any_of(sv.substr(pos), set, [&](std::size_t i) {
+      result = pos + i;
+      return false;
+    });
+  }
+  return result;
+}
+
+
+inline bool equal(const char* a, const char* b, std::size_t size)
+{
+  std::size_t i = 0;
+
+  switch (simd()) {
+#ifdef NONSTD_STRING_UTILS_X86
+    case simd_level::avx512bw:
+      if (!equal_avx512bw(a, b, size, i))
+        return false;
+      [[fallthrough]];
+    case simd_level::avx2:
+      if (!equal_avx2(a, b, size, i))
+        return false;
+      [[fallthrough]];
+    case simd_level::sse2:
+      if (!equal_sse2(a, b, size, i))
+        return false;
+      [[fallthrough]];
+#endif
+    default:
+      break;
+  }
+  for (; i < size; i++) {
+    if (a[i] != b[i])
+      return false;
+  }
+
+  return true;
+}
+
+
+// Eight bytes at a time in a general purpose register, the range check only looks at the low
+// seven bits of each byte so that no carry reaches the next byte
+inline void convert_case_swar(const char* src, char* dst, std::size_t size, char first,
+    std::size_t& i)
+{
+  constexpr std::uint64_t ones = 0x0101010101010101;
+  const std::uint64_t lo = ones * static_cast<unsigned char>(0x80 - first);
+  const std::uint64_t hi = ones * static_cast<unsigned char>(0x80 - (first + 26));
+  for (; i + 8 <= size; i += 8) {
+    auto v = load_eight(src + i);
+    auto low_bits = v & (ones * 0x7F);
+    auto in = (low_bits + lo) & ~(low_bits + hi) & ~v & (ones * 0x80);
+    v ^= in >> 2;
+    std::memcpy(dst + i, &v, sizeof(v));
+  }
+}
+
+
+// ASCII case conversion, src and dst may be the same
+inline void convert_case(const char* src, char* dst, std::size_t size, bool upper)
+{
+  std::size_t i = 0;
+  const char first = upper ? 'a' : 'A';
+
+  // Short strings such as header keys are done before the kernel calls would pay off
+  switch (size < 16 ? simd_level::scalar : simd()) {
+#ifdef NONSTD_STRING_UTILS_X86
+    case simd_level::avx512bw:
+      convert_case_avx512bw(src, dst, size, first, i);
+      [[fallthrough]];
+    case simd_level::avx2:
+      convert_case_avx2(src, dst, size, first, i);
+      [[fallthrough]];
+    case simd_level::sse2:
+      convert_case_sse2(src, dst, size, first, i);
+      [[fallthrough]];
+#endif
+    default:
+      break;
+  }
+  convert_case_swar(src, dst, size, first, i);
+  for (; i < size; i++)
+    dst[i] = src[i] >= first && src[i] <= first + 25 ? static_cast<char>(src[i] ^ 0x20) : src[i];
+}
+
+
+// Rough order of byte frequency in text and code, bytes that are not listed are the rarest
+inline std::size_t byte_rank(char c)
+{
+  constexpr std::string_view common = " etaoinshrdlcumwfgypbvkjxqz\n\t,.0123456789"
+      "ETAOINSHRDLCUMWFGYPBVKJXQZ;:'\"-_()/=<>!?";
+  auto i = common.find(c);
+  return i == std::string_view::npos ? 0 : common.size() - i;
+}
+
+
+}  // namespace nonstd::string_utils::detail
+
+
+namespace nonstd::string_utils
+{
+
+
+// Token prepared once for repeated searches. Single bytes go to the character kernel, the
+// vectorized search filters candidates by the two rarest bytes of tokens from eight bytes on
+// and without vector units tokens from sixteen bytes on use a Horspool skip table. Reverse
+// searches are plain std::string_view::rfind
+class searcher
+{
+public:
+  searcher() = default;
+
+
+  explicit searcher(std::string_view token) : token_{token}
+  {
+    auto m = token_.size();
+    if (m < 2)
+      return;
+
+    second_ = m - 1;
+    if (m >= rare_bytes_size) {
+      for (std::size_t i = 1; i < m; i++) {
+        if (detail::byte_rank(token_[i]) < detail::byte_rank(token_[first_]))
+          first_ = i;
+      }
+      second_ = first_ == 0 ? 1 : 0;
+      for (std::size_t i = 0; i < m; i++) {
+        if (i == first_ || token_[i] == token_[first_])
+          continue;
+        if (token_[second_] == token_[first_] ||
+            detail::byte_rank(token_[i]) < detail::byte_rank(token_[second_]))
+          second_ = i;
+      }
+    }
+
+    if (m >= skip_table_size) {
+      skip_.fill(static_cast<std::uint8_t>(std::min<std::size_t>(m, 255)));
+      for (std::size_t i = 0; i + 1 < m; i++) {
+        skip_[static_cast<unsigned char>(token_[i])] =
+            static_cast<std::uint8_t>(std::min<std::size_t>(m - 1 - i, 255));
+      }
+    }
+  }
+
+
+  std::size_t find(std::string_view sv, std::size_t pos = 0) const
+  {
+    if (token_.size() < 2 || pos > sv.size())
+      return detail::find(sv, token_, pos);
+    if (detail::simd() != simd_level::scalar)
+      return detail::find_filtered(sv, token_, pos, first_, second_);
+    if (token_.size() >= skip_table_size)
+      return horspool(sv, pos);
+    return sv.find(token_, pos);
+  }
+
+
+  std::size_t rfind(std::string_view sv) const
+  {
+    return sv.rfind(token_);
+  }
+
+
+  std::string_view token() const { return token_; }
+  std::size_t size() const { return token_.size(); }
+  bool empty() const { return token_.empty(); }
+
+private:
+  static constexpr std::size_t rare_bytes_size = 8;
+  static constexpr std::size_t skip_table_size = 16;
+
+  std::size_t horspool(std::string_view sv, std::size_t pos) const
+  {
+    const char* p = sv.data();
+    const char* t = token_.data();
+    std::size_t m = token_.size();
+    for (std::size_t i = pos; i + m <= sv.size();) {
+      char c = p[i + m - 1];
+      if (c == t[m - 1] && std::memcmp(p + i, t, m - 1) == 0)
+        return i;
+      i += skip_[static_cast<unsigned char>(c)];
+    }
+    return std::string_view::npos;
+  }
+
+  std::string token_;
+  std::size_t first_ = 0;
+  std::size_t second_ = 0;
+  std::array<std::uint8_t, 256> skip_{};
+};
+
+
+}  // namespace nonstd::string_utils
+
+
+namespace nonstd::string_utils::detail
+{
+
+
+inline std::size_t find(std::string_view sv, const searcher& token, std::size_t pos = 0)
+{
+  return token.find(sv, pos);
+}
+
+
+inline std::size_t rfind(std::string_view sv, const searcher& token)
+{
+  return token.rfind(sv);
+}
+
+
+// The token as it appears in the text
+inline std::string_view token_view(std::string_view token)
+{
+  return token;
+}
+
+
+inline std::string_view token_view(const searcher& token)
+{
+  return token.token();
+}
+
+
+// True when occurrences of the token can overlap, then only a search from the start finds
+// the same matches as split
+inline bool overlaps_itself(std::string_view token)
+{
+  for (std::size_t k = 1; k < token.size(); k++) {
+    if (token.compare(0, k, token, token.size() - k, k) == 0)
+      return true;
+  }
+  return false;
+}
+
+
+// The helpers below take the token type as an explicit template argument, std::string_view
+// unless it is a searcher, so that string literals still convert
+template <typename T> struct non_deduced { using type = T; };
+template <typename T> using non_deduced_t = typename non_deduced<T>::type;
+
+
+// Owning results for a given char allocator, vectors of them use the allocator rebound. The
+// check keeps the allocator taking overloads away from calls passing a bool or a container
+template <typename Allocator> using basic_string_t =
+    std::basic_string<char, std::char_traits<char>, Allocator>;
+template <typename Allocator> using basic_strings_t = std::vector<basic_string_t<Allocator>,
+    typename std::allocator_traits<Allocator>::template rebind_alloc<basic_string_t<Allocator>>>;
+template <typename Allocator> using if_char_allocator_t =
+    std::enable_if_t<std::is_same_v<typename Allocator::value_type, char>>;
+
+
+template <typename T> std::vector<T> split_char(std::string_view sv, char token,
+    bool keep_empty_parts)
+{
+  std::size_t start = 0;
+  std::vector<T> parts;
+
+  for_each_char(sv, token, [&](std::size_t i) {
+    if (keep_empty_parts || i > start)
+      parts.emplace_back(sv.substr(start, i - start));
+    start = i + 1;
+    return true;
+  });
+  if (keep_empty_parts || sv.size() > start)
+    parts.emplace_back(sv.substr(start));
+
+  return parts;
+}
+
+
+template <typename T, typename Token = std::string_view> std::vector<T> split_keep_empty(
+    std::string_view sv, const non_deduced_t<Token>& token)
+{
+  std::size_t start = 0;
+  auto i = detail::find(sv, token);
+  std::vector<T> parts;
+
+  while (i != std::string_view::npos) {
+    parts.emplace_back(sv.substr(start, i - start));
+    start = i + token.size();
+    i = detail::find(sv, token, start);
+  }
+  parts.emplace_back(sv.substr(start));
+
+  return parts;
+}
+
+
+template <typename T, typename Token = std::string_view> std::vector<T> split_ignore_empty(
+    std::string_view sv, const non_deduced_t<Token>& token)
+{
+  std::size_t start = 0;
+  auto i = detail::find(sv, token);
+  std::vector<T> parts;
+
+  while (i != std::string_view::npos) {
+    if (auto len = i - start; len > 0)
+      parts.emplace_back(sv.substr(start, len));
+    start = i + token.size();
+    i = detail::find(sv, token, start);
+  }
+  if (sv.size() - start > 0)
+    parts.emplace_back(sv.substr(start));
+
+  return parts;
+}
+
+
+// Calls func with every part, stops as soon as func returns false
+template <typename Token = std::string_view, typename F> bool for_each_part(std::string_view sv,
+    const non_deduced_t<Token>& token, bool keep_empty_parts, F func)
+{
+  std::size_t start = 0;
+
+  if (token.size() == 1) {
+    auto completed = for_each_char(sv, token_view(token).front(), [&](std::size_t i) {
+      auto keep_going = !(keep_empty_parts || i > start) || func(sv.substr(start, i - start));
+      start = i + 1;
+      return keep_going;
+    });
+    if (!completed)
+      return false;
+  }
+  else if (!token.empty()) {
+    for (auto i = detail::find(sv, token); i != std::string_view::npos;
+        i = detail::find(sv, token, start)) {
+      if ((keep_empty_parts || i > start) && !func(sv.substr(start, i - start)))
+        return false;
+      start = i + token.size();
+    }
+  }
+  if (keep_empty_parts || sv.size() > start)
+    return func(sv.substr(start));
+
+  return true;
+}
+
+
+// Like for_each_part with a token known at compile time, matches overlapping the previous
+// one are skipped so the parts are the same as split gives
+template <char... Ds, typename F> bool for_each_constant_part(std::string_view sv,
+    bool keep_empty_parts, F func)
+{
+  constexpr std::size_t m = sizeof...(Ds);
+  std::size_t start = 0;
+  auto on_token = [&](std::size_t i) {
+    if (i < start)
+      return true;
+    auto keep_going = !(keep_empty_parts || i > start) || func(sv.substr(start, i - start));
+    start = i + m;
+    return keep_going;
+  };
+
+  bool completed;
+  if constexpr (m == 1)
+    completed = for_each_char(sv, first_of<Ds...>, on_token);
+  else
+    completed = for_each_constant<Ds...>(sv, on_token);
+  if (!completed)
+    return false;
+  if (keep_empty_parts || sv.size() > start)
+    return func(sv.substr(start));
+
+  return true;
+}
+
+
+// Callables may return void or bool, returning false stops the iteration
+template <typename F> bool invoke_part(F& func, std::string_view part)
+{
+  if constexpr (std::is_void_v<std::invoke_result_t<F&, std::string_view>>) {
+    func(part);
+    return true;
+  }
+  else {
+    return static_cast<bool>(func(part));
+  }
+}
+
+
+template <typename T> std::vector<T> split_chars(std::string_view sv,
+    std::size_t char_count, std::size_t skip = 0)
+{
+  if (char_count == 0)
+    return std::vector<T>{};
+
+  std::vector<T> v;
+  auto size = sv.size();
+  std::size_t i = 0;
+  while (i < size) {
+    v.emplace_back(sv.substr(i, char_count));
+    i += char_count + skip;
+  }
+
+  return v;
+}
+
+
+template <typename T, typename Token = std::string_view> std::tuple<T, T> split_first(
+    std::string_view sv, const non_deduced_t<Token>& token)
+{
+  if (auto i = detail::find(sv, token); i != std::string_view::npos) {
+    return {T{sv.substr(0, i)}, T{sv.substr(i+token.size())}};
+  }
+  return {T{sv}, T{}};
+}
+
+
+template <typename T, typename Token = std::string_view> std::tuple<T, T> split_last(
+    std::string_view sv, const non_deduced_t<Token>& token)
+{
+  if (auto i = detail::rfind(sv, token); i != std::string_view::npos) {
+    return {T{sv.substr(0, i)}, T{sv.substr(i+token.size())}};
+  }
+  return {T{sv}, T{}};
+}
+
+
+template <typename T, typename Token = std::string_view> T before_first(std::string_view sv,
+    const non_deduced_t<Token>& token)
+{
+  if (auto i = detail::find(sv, token); i != std::string_view::npos) {
+    return T{sv.substr(0, i)};
+  }
+  return T{};
+}
+
+
+template <typename T, typename Token = std::string_view> T before_last(std::string_view sv,
+    const non_deduced_t<Token>& token)
+{
+  if (auto i = detail::rfind(sv, token); i != std::string_view::npos) {
+    return T{sv.substr(0, i)};
+  }
+  return T{};
+}
+
+
+template <typename T, typename Token = std::string_view> T after_first(std::string_view sv,
+    const non_deduced_t<Token>& token)
+{
+  if (auto i = detail::find(sv, token); i != std::string_view::npos) {
+    return T{sv.substr(i + token.size())};
+  }
+  return T{};
+}
+
+
+template <typename T, typename Token = std::string_view> T after_last(std::string_view sv,
+    const non_deduced_t<Token>& token)
+{
+  if (auto i = detail::rfind(sv, token); i != std::string_view::npos) {
+    return T{sv.substr(i + token.size())};
+  }
+  return T{};
+}
+
+
+template <typename T, typename Token = std::string_view> T between(std::string_view sv,
+    const non_deduced_t<Token>& first_token, const non_deduced_t<Token>& second_token,
+    bool greedy = false)
+{
+  if (auto i = detail::find(sv, first_token),
+      j = greedy ? detail::rfind(sv, second_token) : detail::find(sv, second_token);
+      i != std::string_view::npos && j != std::string_view::npos && j > i) {
+    return T{sv.substr(i + first_token.size(), j - i - first_token.size())};
+  }
+  return T{};
+}
+
+
+template <typename T, typename Token = std::string_view> T rbetween(std::string_view sv,
+    const non_deduced_t<Token>& first_token, const non_deduced_t<Token>& second_token,
+    bool greedy = false)
+{
+  if (auto i = detail::rfind(sv, first_token),
+      j = greedy ? detail::find(sv, second_token) : detail::rfind(sv, second_token);
+      i != std::string_view::npos && j != std::string_view::npos && j < i) {
+    return T{sv.substr(j + first_token.size(), i - j - first_token.size())};
+  }
+  return T{};
+}
+
+
+// Up to a small batch of match positions are kept. With more matches a shorter replacement
+// is written into a result as large as the input. A longer one gets a result sized from the
+// density of the batch with some slack, the rest of the matches are counted if it falls short
+template <typename Token = std::string_view, typename Allocator = std::allocator<char>>
+basic_string_t<Allocator> replace(std::string_view sv, const non_deduced_t<Token>& search_token,
+    std::string_view replace_token, const Allocator& alloc = Allocator{})
+{
+  constexpr std::size_t batch_size = 64;
+  std::array<std::size_t, batch_size> batch;
+  std::size_t count = 0;
+  auto p = detail::find(sv, search_token);
+  for (; p != std::string_view::npos && count < batch_size;
+      p = detail::find(sv, search_token, p + search_token.size())) {
+    batch[count++] = p;
+  }
+  if (count == 0)
+    return basic_string_t<Allocator>{sv, alloc};
+
+  const auto growth = replace_token.size() > search_token.size() ?
+      replace_token.size() - search_token.size() : 0;
+  auto size = sv.size() - search_token.size() * count + replace_token.size() * count;
+  if (p != std::string_view::npos) {
+    size = sv.size() + std::max(growth * count * (2 * (sv.size() / p) + 1),
+        growth != 0 ? sv.size() / 8 : 0);
+  }
+
+  basic_string_t<Allocator> result(size, '\0', alloc);
+  std::size_t written = 0;
+  std::size_t start = 0;
+  auto copy = [&](std::size_t pos) {
+    auto result_it = std::copy(sv.data() + start, sv.data() + pos, result.data() + written);
+    result_it = std::copy(std::begin(replace_token), std::end(replace_token), result_it);
+    written = static_cast<std::size_t>(result_it - result.data());
+    start = pos + search_token.size();
+  };
+  for (std::size_t i = 0; i < count; i++)
+    copy(batch[i]);
+  for (; p != std::string_view::npos;
+      p = detail::find(sv, search_token, p + search_token.size())) {
+    if (result.size() - written < sv.size() - start + growth) {
+      std::size_t rest = 0;
+      for (auto q = p; q != std::string_view::npos;
+          q = detail::find(sv, search_token, q + search_token.size())) {
+        rest++;
+      }
+      result.resize(written + sv.size() - start + growth * rest);
+    }
+    copy(p);
+  }
+  std::copy(sv.data() + start, sv.data() + sv.size(), result.data() + written);
+  result.resize(written + sv.size() - start);
+  return result;
+}
+
+
+template <typename Token = std::string_view, typename Allocator = std::allocator<char>>
+basic_string_t<Allocator> replace_inplace(std::string_view sv,
+    const non_deduced_t<Token>& search_token, std::string_view replace_token,
+    const Allocator& alloc = Allocator{})
+{
+  basic_string_t<Allocator> result{sv, alloc};
+  auto result_it = std::begin(result);
+  auto pos = detail::find(sv, search_token);
+  while (pos != std::string_view::npos) {
+    result_it = std::copy(std::begin(replace_token), std::end(replace_token),
+        std::begin(result) + pos);
+    pos = detail::find(sv, search_token, pos + search_token.size());
+  }
+  return result;
+}
+
+
+// Replaces within s and returns the number of replacements. Equal sizes overwrite in place,
+// shorter replacements compact in one forward pass and longer ones are counted, then moved
+// back to front after a single resize. Neither token may refer into s
+template <typename Token = std::string_view> std::size_t replace_in(std::string& s,
+    const non_deduced_t<Token>& search_token, std::string_view replace_token)
+{
+  const auto m = search_token.size();
+  const auto r = replace_token.size();
+  if (m == 0)
+    return 0;
+
+  std::size_t count = 0;
+  if (r <= m) {
+    std::size_t i = 0;
+    std::size_t out = 0;
+    for (auto p = detail::find(s, search_token); p != std::string_view::npos;
+        p = detail::find(s, search_token, p + m)) {
+      if (out != i)
+        std::copy(s.data() + i, s.data() + p, s.data() + out);
+      std::copy(std::begin(replace_token), std::end(replace_token), s.data() + out + p - i);
+      out += p - i + r;
+      i = p + m;
+      count++;
+    }
+    if (r != m && count != 0) {
+      std::copy(s.data() + i, s.data() + s.size(), s.data() + out);
+      s.resize(out + s.size() - i);
+    }
+    return count;
+  }
+
+  // Only every 64th match is kept, the ones in between are found again when moving a batch
+  constexpr std::size_t batch_size = 64;
+  std::vector<std::size_t> batch_starts;
+  for (auto p = detail::find(s, search_token); p != std::string_view::npos;
+      p = detail::find(s, search_token, p + m)) {
+    if (count % batch_size == 0)
+      batch_starts.push_back(p);
+    count++;
+  }
+  if (count == 0)
+    return 0;
+
+  auto end = s.size();
+  s.resize(s.size() + (r - m) * count);
+  auto out = s.size();
+  std::array<std::size_t, batch_size> batch;
+  for (auto first = batch_starts.rbegin(); first != batch_starts.rend(); ++first) {
+    std::size_t n = 0;
+    for (auto p = *first; p != std::string_view::npos && n < batch_size;
+        p = detail::find(std::string_view{s.data(), end}, search_token, p + m)) {
+      batch[n++] = p;
+    }
+    while (n > 0) {
+      auto p = batch[--n];
+      out -= end - p - m;
+      std::copy_backward(s.data() + p + m, s.data() + end, s.data() + out + end - p - m);
+      out -= r;
+      std::copy(std::begin(replace_token), std::end(replace_token), s.data() + out);
+      end = p;
+    }
+  }
+  return count;
+}
+
+
+}  // namepsace nonstd::string_utils::detail
+
+
+// The following functions expect ASCII
+//
+
+namespace nonstd::string_utils::ascii  
+{
+
+
+inline void to_upper(std::string& s)
+{
+  detail::convert_case(s.data(), s.data(), s.size(), true);
+}
+
+
+inline void to_lower(std::string& s)
+{
+  detail::convert_case(s.data(), s.data(), s.size(), false);
+}
+
+
+inline std::string as_upper(std::string_view sv)
+{
+  std::string s{sv};
+  detail::convert_case(s.data(), s.data(), s.size(), true);
+  return s;
+}
+
+
+inline std::string as_lower(std::string_view sv)
+{
+  std::string s{sv};
+  detail::convert_case(s.data(), s.data(), s.size(), false);
+  return s;
+}
+
+
+// Writes sv.size() bytes to out, which may be sv.data() itself, and returns them as a view
+inline std::string_view as_upper(std::string_view sv, char* out)
+{
+  detail::convert_case(sv.data(), out, sv.size(), true);
+  return {out, sv.size()};
+}
+
+
+inline std::string_view as_lower(std::string_view sv, char* out)
+{
+  detail::convert_case(sv.data(), out, sv.size(), false);
+  return {out, sv.size()};
+}
+
+
+// Results using the given allocator, e.g. std::pmr::polymorphic_allocator<char>
+template <typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> as_upper(std::string_view sv, const Allocator& alloc)
+{
+  detail::basic_string_t<Allocator> s{sv, alloc};
+  detail::convert_case(s.data(), s.data(), s.size(), true);
+  return s;
+}
+
+
+template <typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> as_lower(std::string_view sv, const Allocator& alloc)
+{
+  detail::basic_string_t<Allocator> s{sv, alloc};
+  detail::convert_case(s.data(), s.data(), s.size(), false);
+  return s;
+}
+
+
+}  // namespace nonstd::string_utils::ascii
+
+
+namespace nonstd::string_utils
+{
+
+
+// Kernel selection, the best supported level is detected once on first use and can be
+// lowered with the NONSTD_STRING_UTILS_SIMD environment variable (scalar, sse2, avx2, avx512bw)
+//
+
+inline simd_level detected_simd_level()
+{
+  static const auto level = detail::detect_simd_level();
+  return level;
+}
+
+
+inline simd_level active_simd_level()
+{
+  return detail::simd();
+}
+
+
+// Levels above the detected one are clamped to it
+inline void set_simd_level(simd_level level)
+{
+  detail::active_simd_level().store(std::min(level, detected_simd_level()),
+      std::memory_order_relaxed);
+}
+
+
+// The following functions are not Unicode aware and simply do byte comparisons
+//
+
+inline bool starts_with(std::string_view sv, std::string_view test)
+{
+  if (sv.empty() || test.empty() || test.size() > sv.size())
+    return false;
+  return detail::equal(sv.data(), test.data(), test.size());
+}
+
+
+inline bool ends_with(std::string_view sv, std::string_view test)
+{
+  if (sv.empty() || test.empty() || test.size() > sv.size())
+    return false;
+  return detail::equal(sv.data() + sv.size() - test.size(), test.data(), test.size());
+}
+
+
+inline std::vector<std::string_view> split(std::string_view sv,
+    std::string_view token, bool keep_empty_parts = true)
+{
+  if (token.size() == 1)
+    return detail::split_char<std::string_view>(sv, token.front(), keep_empty_parts);
+  if (keep_empty_parts)
+    return detail::split_keep_empty<std::string_view>(sv, token);
+  return detail::split_ignore_empty<std::string_view>(sv, token);
+}
+
+
+inline std::vector<std::string_view> split(std::string_view sv, char token,
+    bool keep_empty_parts = true)
+{
+  return detail::split_char<std::string_view>(sv, token, keep_empty_parts);
+}
+
+
+inline std::vector<std::string> split_copy(std::string_view sv,
+    std::string_view token, bool keep_empty_parts = true)
+{
+  if (token.size() == 1)
+    return detail::split_char<std::string>(sv, token.front(), keep_empty_parts);
+  if (keep_empty_parts)
+    return detail::split_keep_empty<std::string>(sv, token);
+  return detail::split_ignore_empty<std::string>(sv, token);
+}
+
+
+inline std::vector<std::string> split_copy(std::string_view sv, char token,
+    bool keep_empty_parts = true)
+{
+  return detail::split_char<std::string>(sv, token, keep_empty_parts);
+}
+
+
+// Tokens known at compile time, e.g. split<','>(sv) or split<'\r', '\n'>(sv). Single bytes use
+// the character kernel, longer tokens are found in one pass over the input instead of a new
+// search per part
+//
+
+template <char D, char... Ds> std::vector<std::string_view> split(std::string_view sv,
+    bool keep_empty_parts = true)
+{
+  std::vector<std::string_view> parts;
+  detail::for_each_constant_part<D, Ds...>(sv, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(part);
+    return true;
+  });
+  return parts;
+}
+
+
+template <char D, char... Ds> std::vector<std::string> split_copy(std::string_view sv,
+    bool keep_empty_parts = true)
+{
+  std::vector<std::string> parts;
+  detail::for_each_constant_part<D, Ds...>(sv, keep_empty_parts, [&](std::string_view part) {
+    parts.emplace_back(part);
+    return true;
+  });
+  return parts;
+}
+
+
+template <char D, char... Ds, typename F> bool split_for_each(std::string_view sv, F fn,
+    bool keep_empty_parts = true)
+{
+  return detail::for_each_constant_part<D, Ds...>(sv, keep_empty_parts,
+      [&](std::string_view part) { return detail::invoke_part(fn, part); });
+}
+
+
+// Lazy alternative to split, parts are found one at a time while iterating
+//
+
+class split_view
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    iterator() = default;
+
+    reference operator*() const { return part_; }
+    pointer operator->() const { return &part_; }
+
+    iterator& operator++()
+    {
+      advance();
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      auto it = *this;
+      advance();
+      return it;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b)
+    {
+      if (a.at_end_ || b.at_end_)
+        return a.at_end_ == b.at_end_;
+      return a.part_.data() == b.part_.data() && a.next_ == b.next_;
+    }
+
+    friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+  private:
+    friend class split_view;
+
+    iterator(std::string_view sv, std::string_view token, bool keep_empty_parts)
+        : sv_{sv}, token_{token}, keep_empty_parts_{keep_empty_parts}, next_{0}, at_end_{false}
+    {
+      advance();
+    }
+
+    void advance()
+    {
+      do {
+        if (next_ == std::string_view::npos) {
+          at_end_ = true;
+          return;
+        }
+        auto i = token_.empty() ? std::string_view::npos : detail::find(sv_, token_, next_);
+        if (i == std::string_view::npos) {
+          part_ = sv_.substr(next_);
+          next_ = std::string_view::npos;
+        }
+        else {
+          part_ = sv_.substr(next_, i - next_);
+          next_ = i + token_.size();
+        }
+      } while (!keep_empty_parts_ && part_.empty());
+    }
+
+    std::string_view sv_;
+    std::string_view token_;
+    std::string_view part_;
+    bool keep_empty_parts_ = true;
+    std::size_t next_ = std::string_view::npos;
+    bool at_end_ = true;
+  };
+
+  split_view(std::string_view sv, std::string_view token, bool keep_empty_parts = true)
+      : sv_{sv}, token_{token}, keep_empty_parts_{keep_empty_parts} {}
+
+  iterator begin() const { return iterator{sv_, token_, keep_empty_parts_}; }
+  iterator end() const { return iterator{}; }
+
+private:
+  std::string_view sv_;
+  std::string_view token_;
+  bool keep_empty_parts_;
+};
+
+
+// Lazy range over the lines of a text, a line break is "\n" and a break at the very end
+// does not start another line. A "\r" before the break is removed unless strip_cr is false.
+// Line breaks are found 64 bytes at a time and kept as a bit mask between lines
+//
+
+class line_view
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    iterator() = default;
+
+    reference operator*() const { return line_; }
+    pointer operator->() const { return &line_; }
+
+    iterator& operator++()
+    {
+      advance();
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      auto it = *this;
+      advance();
+      return it;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b)
+    {
+      return a.next_ == b.next_ && (a.next_ == std::string_view::npos ||
+          a.sv_.data() == b.sv_.data());
+    }
+
+    friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+  private:
+    friend class line_view;
+
+    iterator(std::string_view sv, bool strip_cr) : sv_{sv}, next_{0}, strip_cr_{strip_cr}
+    {
+      mask_ = detail::char_mask(sv_.data(), sv_.size(), '\n');
+      advance();
+    }
+
+    void advance()
+    {
+      const auto size = sv_.size();
+      if (next_ >= size) {
+        next_ = std::string_view::npos;
+        return;
+      }
+      while (mask_ == 0 && block_ + 64 < size) {
+        block_ += 64;
+        mask_ = detail::char_mask(sv_.data() + block_, size - block_, '\n');
+      }
+      auto i = size;
+      if (mask_ != 0) {
+        i = block_ + detail::lowest_bit(mask_);
+        mask_ &= mask_ - 1;
+      }
+      line_ = sv_.substr(next_, i - next_);
+      if (strip_cr_ && !line_.empty() && line_.back() == '\r')
+        line_.remove_suffix(1);
+      next_ = i + 1;
+    }
+
+    std::string_view sv_;
+    std::string_view line_;
+    std::size_t next_ = std::string_view::npos;
+    std::size_t block_ = 0;
+    std::uint64_t mask_ = 0;
+    bool strip_cr_ = true;
+  };
+
+  explicit line_view(std::string_view sv, bool strip_cr = true) : sv_{sv}, strip_cr_{strip_cr} {}
+
+  iterator begin() const { return iterator{sv_, strip_cr_}; }
+  iterator end() const { return iterator{}; }
+
+private:
+  std::string_view sv_;
+  bool strip_cr_;
+};
+
+
+inline line_view lines(std::string_view sv, bool strip_cr = true)
+{
+  return line_view{sv, strip_cr};
+}
+
+
+#ifdef NONSTD_STRING_UTILS_MMAP
+  // Read only view of a whole file mapped into memory, converts to std::string_view so the
+  // contents can be used without copying them. The kernel is told the file is read
+  // sequentially; populate reads it all in up front and huge_pages asks for huge pages where
+  // the file system supports them. Check is_open() as with std::ifstream
+  class mapped_file
+  {
+  public:
+    mapped_file() = default;
+
+
+    explicit mapped_file(const std::string& path, bool populate = false,
+        bool huge_pages = false)
+    {
+      auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        return;
+      struct stat st;
+      if (::fstat(fd, &st) == 0) {
+        auto size = static_cast<std::size_t>(st.st_size);
+        int flags = MAP_PRIVATE;
+        #ifdef MAP_POPULATE
+          if (populate)
+            flags |= MAP_POPULATE;
+        #endif
+        if (size == 0) {
+          open_ = true;
+        }
+        else if (auto p = ::mmap(nullptr, size, PROT_READ, flags, fd, 0); p != MAP_FAILED) {
+          data_ = static_cast<const char*>(p);
+          size_ = size;
+          open_ = true;
+          ::madvise(p, size, MADV_SEQUENTIAL);
+          #ifdef MADV_HUGEPAGE
+            if (huge_pages)
+              ::madvise(p, size, MADV_HUGEPAGE);
+          #endif
+        }
+      }
+      ::close(fd);
+      static_cast<void>(populate);
+      static_cast<void>(huge_pages);
+    }
+
+
+    mapped_file(mapped_file&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)},
+        open_{std::exchange(other.open_, false)}
+    {
+    }
+
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+      if (this != &other) {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        open_ = std::exchange(other.open_, false);
+      }
+      return *this;
+    }
+
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+
+    ~mapped_file()
+    {
+      unmap();
+    }
+
+
+    bool is_open() const { return open_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return std::string_view{data_, size_}; }
+    operator std::string_view() const { return view(); }
+
+  private:
+    void unmap()
+    {
+      if (data_ != nullptr)
+        ::munmap(const_cast<char*>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+      open_ = false;
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool open_ = false;
+  };
+#endif  // NONSTD_STRING_UTILS_MMAP
+
+
+// Same parts as split, on up to thread_count threads or one per core when it is 0. The
+// input is cut right after a token near each thread's share, so every range splits on its
+// own. Tokens that can overlap themselves and small inputs are split on the calling thread
+inline std::vector<std::string_view> parallel_split(std::string_view sv,
+    std::string_view token, std::size_t thread_count = 0, bool keep_empty_parts = true)
+{
+  constexpr std::size_t min_range_size = 1 << 16;
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, sv.size() / min_range_size);
+  if (thread_count <= 1 || token.empty() || detail::overlaps_itself(token))
+    return split(sv, token, keep_empty_parts);
+
+  std::vector<std::string_view> ranges;
+  std::size_t start = 0;
+  for (std::size_t k = 1; k < thread_count; k++) {
+    auto i = detail::find(sv, token, std::max(start, sv.size() / thread_count * k));
+    if (i == std::string_view::npos)
+      break;
+    ranges.push_back(sv.substr(start, i - start));
+    start = i + token.size();
+  }
+  ranges.push_back(sv.substr(start));
+
+  std::vector<std::future<std::vector<std::string_view>>> results;
+  for (std::size_t k = 1; k < ranges.size(); k++) {
+    results.push_back(std::async(std::launch::async, [&, k] {
+      return split(ranges[k], token, keep_empty_parts);
+    }));
+  }
+  auto parts = split(ranges.front(), token, keep_empty_parts);
+  std::vector<std::vector<std::string_view>> range_parts;
+  auto count = parts.size();
+  for (auto& result : results) {
+    range_parts.push_back(result.get());
+    count += range_parts.back().size();
+  }
+  parts.reserve(count);
+  for (const auto& v : range_parts)
+    parts.insert(parts.end(), v.begin(), v.end());
+  return parts;
+}
+
+
+// A field of a CSV record, quoted fields are given without their quotes but with any
+// doubled quotes inside them left as they are
+//
+
+struct csv_field
+{
+  std::string_view raw{};
+  bool escaped = false;
+
+  // Undoes doubled quotes in buffer when there are any, raw is returned otherwise
+  std::string_view value(std::string& buffer) const
+  {
+    if (!escaped)
+      return raw;
+    buffer.clear();
+    for (std::size_t i = 0; i < raw.size(); i++) {
+      buffer += raw[i];
+      if (raw[i] == '"' && i + 1 < raw.size() && raw[i + 1] == '"')
+        i++;
+    }
+    return buffer;
+  }
+
+
+  std::string value_copy() const
+  {
+    std::string buffer;
+    return std::string{value(buffer)};
+  }
+};
+
+
+// Reads RFC 4180 CSV one record at a time, records end with "\n" or "\r\n" outside of
+// quotes. The input is classified 64 bytes at a time: a prefix xor over the quote mask
+// marks the quoted bytes, and only delimiters and line breaks outside of those end fields.
+// A quote opens a quoted field only as the first byte of a field, elsewhere it is data, so
+// a stray quote stays within its field. A quoted field that is never closed runs up to the
+// end of the input, as its line breaks cannot be told apart from quoted ones
+//
+
+class csv_reader
+{
+public:
+  explicit csv_reader(std::string_view sv, char delimiter = ',')
+    : sv_{sv}, delimiter_{delimiter}
+  {
+    classify();
+  }
+
+
+  // Fields of the next record replace the ones in fields, false when there are no more
+  bool read_record(std::vector<csv_field>& fields)
+  {
+    fields.clear();
+    if (pos_ >= sv_.size())
+      return false;
+
+    for (;;) {
+      while (mask_ == 0 && block_ + 64 < sv_.size()) {
+        block_ += 64;
+        classify();
+      }
+      auto end = sv_.size();
+      if (mask_ != 0) {
+        end = block_ + detail::lowest_bit(mask_);
+        mask_ &= mask_ - 1;
+      }
+      const bool last = end == sv_.size() || sv_[end] == '\n';
+      fields.push_back(field(pos_, end, last));
+      pos_ = end + 1;
+      if (last)
+        return true;
+    }
+  }
+
+private:
+  void classify()
+  {
+    const char* p = sv_.data() + block_;
+    const auto size = sv_.size() - std::min(block_, sv_.size());
+    const auto ends = detail::char_mask(p, size, delimiter_) | detail::char_mask(p, size, '\n');
+    const bool at_start = block_ == 0 || sv_[block_ - 1] == delimiter_ ||
+        sv_[block_ - 1] == '\n';
+    const auto starts = ends << 1 | static_cast<std::uint64_t>(at_start);
+
+    // Outside of quotes only a quote that starts a field or directly follows a closing one
+    // counts, any quote closes inside of them. Quotes are rare enough to visit one by one
+    std::uint64_t quotes = 0;
+    bool inside = in_quotes_ != 0;
+    for (auto q = detail::char_mask(p, size, '"'); q != 0; q &= q - 1) {
+      const auto j = detail::lowest_bit(q);
+      if (!inside && (starts >> j & 1) == 0 && block_ + j != reopen_)
+        continue;
+      quotes |= std::uint64_t{1} << j;
+      inside = !inside;
+      if (!inside)
+        reopen_ = block_ + j + 1;
+    }
+    auto quoted = detail::prefix_xor(quotes) ^ in_quotes_;
+    in_quotes_ = inside ? ~std::uint64_t{0} : 0;
+    mask_ = ends & ~quoted;
+  }
+
+
+  csv_field field(std::size_t first, std::size_t last, bool ends_record) const
+  {
+    auto raw = sv_.substr(first, last - first);
+    if (ends_record && !raw.empty() && raw.back() == '\r')
+      raw.remove_suffix(1);
+    if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+      raw = raw.substr(1, raw.size() - 2);
+      return csv_field{raw, raw.find('"') != std::string_view::npos};
+    }
+    return csv_field{raw, false};
+  }
+
+  std::string_view sv_;
+  char delimiter_;
+  std::size_t pos_ = 0;
+  std::size_t block_ = 0;
+  std::uint64_t mask_ = 0;
+  std::uint64_t in_quotes_ = 0;
+  std::size_t reopen_ = std::string_view::npos;
+};
+
+
+// Positions of every byte of a set of delimiters, found in one vectorized pass so that
+// repeated queries on the same text do not scan it again. Parts are the ones split would
+// give with any of the delimiters as token. Positions are kept as 32 bit offsets, with the
+// index of the first position of every further 4 GiB of text
+//
+
+class delimiter_index
+{
+public:
+  delimiter_index(std::string_view sv, std::string_view delimiters) : sv_{sv}
+  {
+    detail::for_each_any_of(sv, delimiters, [&](std::size_t i) {
+      while (static_cast<std::uint64_t>(i) >> 32 >= block_starts_.size())
+        block_starts_.push_back(low_.size());
+      low_.push_back(static_cast<std::uint32_t>(i));
+      return true;
+    });
+  }
+
+
+  // Number of delimiters, there is one part more
+  std::size_t count() const { return low_.size(); }
+
+
+  // Number of delimiters in [first, last)
+  std::size_t count(std::size_t first, std::size_t last) const
+  {
+    return last <= first ? 0 : lower_bound(last) - lower_bound(first);
+  }
+
+
+  // Position of the i-th delimiter
+  std::size_t position(std::size_t i) const
+  {
+    if (block_starts_.size() == 1)
+      return low_[i];
+    auto block = std::upper_bound(block_starts_.begin(), block_starts_.end(), i) -
+        block_starts_.begin() - 1;
+    return static_cast<std::size_t>(static_cast<std::uint64_t>(block) << 32 | low_[i]);
+  }
+
+
+  // Position of the first delimiter at or after pos
+  std::size_t find(std::size_t pos = 0) const
+  {
+    auto i = lower_bound(pos);
+    return i < count() ? position(i) : std::string_view::npos;
+  }
+
+
+  // The n-th part, the same as split(sv, ...)[n] with empty parts kept
+  std::string_view part(std::size_t n) const
+  {
+    if (n > count())
+      return std::string_view{};
+    auto first = n == 0 ? 0 : position(n - 1) + 1;
+    auto last = n == count() ? sv_.size() : position(n);
+    return sv_.substr(first, last - first);
+  }
+
+
+  std::vector<std::string_view> split(bool keep_empty_parts = true) const
+  {
+    std::vector<std::string_view> parts;
+    parts.reserve(count() + 1);
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < count(); i++) {
+      auto pos = position(i);
+      if (keep_empty_parts || pos > start)
+        parts.emplace_back(sv_.data() + start, pos - start);
+      start = pos + 1;
+    }
+    if (keep_empty_parts || sv_.size() > start)
+      parts.emplace_back(sv_.data() + start, sv_.size() - start);
+    return parts;
+  }
+
+private:
+  // Index of the first delimiter at or after pos
+  std::size_t lower_bound(std::size_t pos) const
+  {
+    std::size_t first = 0;
+    std::size_t n = count();
+    while (n > 0) {
+      auto half = n / 2;
+      if (position(first + half) < pos) {
+        first += half + 1;
+        n -= half + 1;
+      }
+      else {
+        n = half;
+      }
+    }
+    return first;
+  }
+
+  std::string_view sv_;
+  std::vector<std::uint32_t> low_;
+  std::vector<std::size_t> block_starts_;
+};
+
+
+// Strings stored back to back in one buffer with a 32 bit offset to the end of each, as in
+// the Arrow string layout. Every string costs four bytes on top of its characters instead of
+// a std::string or std::string_view each, and elements are read as views into the buffer,
+// which stay valid until the column is changed. Columns hold up to 4 GiB of characters,
+// beyond that push_back throws std::length_error
+//
+
+class string_column
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    iterator() = default;
+
+    reference operator*() const { return (*column_)[i_]; }
+    reference operator[](difference_type n) const { return (*column_)[i_ + n]; }
+
+    iterator& operator++()
+    {
+      ++i_;
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      auto it = *this;
+      ++i_;
+      return it;
+    }
+
+    iterator& operator--()
+    {
+      --i_;
+      return *this;
+    }
+
+    iterator operator--(int)
+    {
+      auto it = *this;
+      --i_;
+      return it;
+    }
+
+    iterator& operator+=(difference_type n)
+    {
+      i_ += n;
+      return *this;
+    }
+
+    iterator& operator-=(difference_type n)
+    {
+      i_ -= n;
+      return *this;
+    }
+
+    friend iterator operator+(iterator it, difference_type n) { return it += n; }
+    friend iterator operator+(difference_type n, iterator it) { return it += n; }
+    friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+
+    friend difference_type operator-(const iterator& a, const iterator& b)
+    {
+      return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) { return a.i_ == b.i_; }
+    friend bool operator!=(const iterator& a, const iterator& b) { return a.i_ != b.i_; }
+    friend bool operator<(const iterator& a, const iterator& b) { return a.i_ < b.i_; }
+    friend bool operator>(const iterator& a, const iterator& b) { return a.i_ > b.i_; }
+    friend bool operator<=(const iterator& a, const iterator& b) { return a.i_ <= b.i_; }
+    friend bool operator>=(const iterator& a, const iterator& b) { return a.i_ >= b.i_; }
+
+  private:
+    friend class string_column;
+
+    iterator(const string_column* column, std::size_t i) : column_{column}, i_{i} {}
+
+    const string_column* column_ = nullptr;
+    std::size_t i_ = 0;
+  };
+
+
+  std::size_t size() const { return offsets_.size() - 1; }
+  bool empty() const { return size() == 0; }
+
+
+  std::string_view operator[](std::size_t i) const
+  {
+    return std::string_view{chars_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+  }
+
+
+  std::string_view front() const { return (*this)[0]; }
+  std::string_view back() const { return (*this)[size() - 1]; }
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{this, size()}; }
+
+
+  // All characters without separators, and the offsets, size() + 1 of them starting at 0
+  std::string_view chars() const { return chars_; }
+  const std::vector<std::uint32_t>& offsets() const { return offsets_; }
+
+
+  void push_back(std::string_view sv)
+  {
+    if (sv.size() > std::numeric_limits<std::uint32_t>::max() - chars_.size())
+      throw std::length_error{"string_column exceeds 4 GiB"};
+    chars_.append(sv);
+    offsets_.push_back(static_cast<std::uint32_t>(chars_.size()));
+  }
+
+
+  void reserve(std::size_t count, std::size_t char_count)
+  {
+    offsets_.reserve(count + 1);
+    chars_.reserve(char_count);
+  }
+
+
+  // Capacity is kept for reuse
+  void clear()
+  {
+    chars_.clear();
+    offsets_.resize(1);
+  }
+
+private:
+  std::string chars_;
+  std::vector<std::uint32_t> offsets_{0};
+};
+
+
+// Copies the parts into a column, which is cleared first and keeps its capacity
+inline void split_into_column(std::string_view sv, std::string_view token,
+    string_column& column, bool keep_empty_parts = true)
+{
+  column.clear();
+  column.reserve(0, sv.size());
+  detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    column.push_back(part);
+    return true;
+  });
+}
+
+
+inline string_column split_into_column(std::string_view sv, std::string_view token,
+    bool keep_empty_parts = true)
+{
+  string_column column;
+  split_into_column(sv, token, column, keep_empty_parts);
+  return column;
+}
+
+
+// Vector of trivially copyable elements that keeps up to N of them inline and only allocates
+// when more are added, for results that are usually short
+//
+
+template <typename T, std::size_t N> class small_vector
+{
+  static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+      "small_vector copies its elements as bytes");
+  static_assert(N > 0, "small_vector needs inline capacity");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  small_vector() = default;
+
+
+  small_vector(const small_vector& other)
+  {
+    assign(other);
+  }
+
+
+  small_vector(small_vector&& other) noexcept
+  {
+    take(other);
+  }
+
+
+  small_vector& operator=(const small_vector& other)
+  {
+    if (this != &other) {
+      size_ = 0;
+      assign(other);
+    }
+    return *this;
+  }
+
+
+  small_vector& operator=(small_vector&& other) noexcept
+  {
+    if (this != &other) {
+      heap_.reset();
+      take(other);
+    }
+    return *this;
+  }
+
+
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+  // True while the elements are stored inline
+  bool is_inline() const { return data_ == inline_.data(); }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+  T& operator[](std::size_t i) { return data_[i]; }
+  const T& operator[](std::size_t i) const { return data_[i]; }
+  T& front() { return data_[0]; }
+  const T& front() const { return data_[0]; }
+  T& back() { return data_[size_ - 1]; }
+  const T& back() const { return data_[size_ - 1]; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+
+  // By value, so that an element of this vector can be added while it grows
+  void push_back(T value)
+  {
+    if (size_ == capacity_)
+      grow(capacity_ * 2);
+    data_[size_++] = value;
+  }
+
+
+  template <typename... Args> T& emplace_back(Args&&... args)
+  {
+    push_back(T(std::forward<Args>(args)...));
+    return back();
+  }
+
+
+  void reserve(std::size_t capacity)
+  {
+    if (capacity > capacity_)
+      grow(capacity);
+  }
+
+
+  // Keeps any heap storage for reuse
+  void clear() { size_ = 0; }
+
+
+  friend bool operator==(const small_vector& a, const small_vector& b)
+  {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+
+  friend bool operator!=(const small_vector& a, const small_vector& b) { return !(a == b); }
+
+private:
+  void grow(std::size_t capacity)
+  {
+    std::unique_ptr<T[]> heap{new T[capacity]};
+    std::copy(data_, data_ + size_, heap.get());
+    heap_ = std::move(heap);
+    data_ = heap_.get();
+    capacity_ = capacity;
+  }
+
+  void assign(const small_vector& other)
+  {
+    reserve(other.size_);
+    std::copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+
+  void take(small_vector& other)
+  {
+    if (other.is_inline()) {
+      data_ = inline_.data();
+      capacity_ = N;
+      std::copy(other.begin(), other.end(), data_);
+    }
+    else {
+      heap_ = std::move(other.heap_);
+      data_ = heap_.get();
+      capacity_ = other.capacity_;
+      other.data_ = other.inline_.data();
+      other.capacity_ = N;
+    }
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  std::array<T, N> inline_;
+  std::unique_ptr<T[]> heap_;
+  T* data_ = inline_.data();
+  std::size_t size_ = 0;
+  std::size_t capacity_ = N;
+};
+
+
+// Same parts as split, the first N are kept inline in the result
+template <std::size_t N> small_vector<std::string_view, N> split_small(std::string_view sv,
+    std::string_view token, bool keep_empty_parts = true)
+{
+  small_vector<std::string_view, N> parts;
+  detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(part);
+    return true;
+  });
+  return parts;
+}
+
+
+// Monotonic buffer for strings, copies are appended to large blocks and stay valid until the
+// arena is cleared or destroyed, which frees a few blocks instead of a string each. Requests
+// larger than the block size get a block of their own
+//
+
+class string_arena
+{
+public:
+  explicit string_arena(std::size_t block_size = 65536) : block_size_{block_size} {}
+
+
+  // The blocks are taken over, other is left empty and allocates blocks of its own again
+  string_arena(string_arena&& other) noexcept
+    : block_size_{other.block_size_}, blocks_{std::exchange(other.blocks_, {})},
+      next_{std::exchange(other.next_, nullptr)}, left_{std::exchange(other.left_, 0)},
+      used_{std::exchange(other.used_, 0)}
+  {
+  }
+
+
+  string_arena& operator=(string_arena&& other) noexcept
+  {
+    if (this != &other) {
+      block_size_ = other.block_size_;
+      blocks_ = std::exchange(other.blocks_, {});
+      next_ = std::exchange(other.next_, nullptr);
+      left_ = std::exchange(other.left_, 0);
+      used_ = std::exchange(other.used_, 0);
+    }
+    return *this;
+  }
+
+
+  string_arena(const string_arena&) = delete;
+  string_arena& operator=(const string_arena&) = delete;
+
+
+  // Makes sure the next size bytes allocated come from one block
+  void reserve(std::size_t size)
+  {
+    if (size > left_)
+      add_block(std::max(size, block_size_));
+  }
+
+
+  char* allocate(std::size_t size)
+  {
+    reserve(size);
+    auto p = next_;
+    next_ += size;
+    left_ -= size;
+    return p;
+  }
+
+
+  std::string_view copy(std::string_view sv)
+  {
+    if (sv.empty())
+      return std::string_view{};
+    auto p = allocate(sv.size());
+    std::memcpy(p, sv.data(), sv.size());
+    return std::string_view{p, sv.size()};
+  }
+
+
+  // Invalidates all copies, only the largest block is kept for reuse
+  void clear()
+  {
+    if (blocks_.empty()) {
+      next_ = nullptr;
+      left_ = 0;
+      used_ = 0;
+      return;
+    }
+    auto largest = std::max_element(blocks_.begin(), blocks_.end(),
+        [](const block& a, const block& b) { return a.size < b.size; });
+    std::swap(*largest, blocks_.front());
+    blocks_.resize(1);
+    next_ = blocks_.front().data.get();
+    left_ = blocks_.front().size;
+    used_ = 0;
+  }
+
+
+  // Bytes handed out since construction or the last clear
+  std::size_t size() const { return used_ + (blocks_.empty() ? 0 : blocks_.back().size - left_); }
+
+private:
+  struct block
+  {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  void add_block(std::size_t size)
+  {
+    if (!blocks_.empty())
+      used_ += blocks_.back().size - left_;
+    blocks_.push_back(block{std::unique_ptr<char[]>{new char[size]}, size});
+    next_ = blocks_.back().data.get();
+    left_ = size;
+  }
+
+  std::size_t block_size_;
+  std::vector<block> blocks_;
+  char* next_ = nullptr;
+  std::size_t left_ = 0;
+  std::size_t used_ = 0;
+};
+
+
+// Parts are copied into the arena and returned as views into it, all of them from one block
+inline void split_copy(std::string_view sv, std::string_view token, string_arena& arena,
+    std::vector<std::string_view>& parts, bool keep_empty_parts = true)
+{
+  parts.clear();
+  arena.reserve(sv.size());
+  detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(arena.copy(part));
+    return true;
+  });
+}
+
+
+inline std::vector<std::string_view> split_copy(std::string_view sv, std::string_view token,
+    string_arena& arena, bool keep_empty_parts = true)
+{
+  std::vector<std::string_view> parts;
+  split_copy(sv, token, arena, parts, keep_empty_parts);
+  return parts;
+}
+
+
+// Reuse the capacity of the given vector, it is cleared before the parts are added
+inline void split(std::string_view sv, std::string_view token,
+    std::vector<std::string_view>& parts, bool keep_empty_parts = true)
+{
+  parts.clear();
+  detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(part);
+    return true;
+  });
+}
+
+
+// Existing strings are assigned to and keep their buffers
+inline void split_copy(std::string_view sv, std::string_view token,
+    std::vector<std::string>& parts, bool keep_empty_parts = true)
+{
+  std::size_t count = 0;
+  detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    if (count < parts.size())
+      parts[count].assign(part);
+    else
+      parts.emplace_back(part);
+    count++;
+    return true;
+  });
+  parts.resize(count);
+}
+
+
+template <typename OutputIt> OutputIt split_to(std::string_view sv, std::string_view token,
+    OutputIt out, bool keep_empty_parts = true)
+{
+  detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    *out++ = part;
+    return true;
+  });
+  return out;
+}
+
+
+// Calls fn with every part without building a container, returning false from fn stops
+// early; the return value tells if all parts were visited
+template <typename F> bool split_for_each(std::string_view sv, std::string_view token, F fn,
+    bool keep_empty_parts = true)
+{
+  return detail::for_each_part(sv, token, keep_empty_parts, [&](std::string_view part) {
+    return detail::invoke_part(fn, part);
+  });
+}
+
+
+inline std::vector<std::string_view> split_chars(std::string_view sv,
+    std::size_t char_count, std::size_t skip = 0)
+{
+  return detail::split_chars<std::string_view>(sv, char_count, skip);
+}
+
+
+inline std::vector<std::string> split_chars_copy(std::string_view sv,
+  std::size_t char_count, std::size_t skip = 0)
+{
+  return detail::split_chars<std::string>(sv, char_count, skip);
+}
+
+
+template <typename F> bool split_chars_for_each(std::string_view sv, std::size_t char_count,
+    std::size_t skip, F fn)
+{
+  if (char_count == 0)
+    return true;
+
+  for (std::size_t i = 0; i < sv.size(); i += char_count + skip) {
+    if (!detail::invoke_part(fn, sv.substr(i, char_count)))
+      return false;
+  }
+
+  return true;
+}
+
+
+inline std::tuple<std::string_view, std::string_view> split_first(std::string_view sv,
+    std::string_view token)
+{
+  return detail::split_first<std::string_view>(sv, token);
+}
+
+
+inline std::tuple<std::string, std::string> split_first_copy(std::string_view sv,
+    std::string_view token)
+{
+  return detail::split_first<std::string>(sv, token);
+}
+
+
+inline std::tuple<std::string_view, std::string_view> split_last(std::string_view sv,
+    std::string_view token)
+{
+  return detail::split_last<std::string_view>(sv, token);
+}
+
+
+inline std::tuple<std::string, std::string> split_last_copy(std::string_view sv,
+    std::string_view token)
+{
+  return detail::split_last<std::string>(sv, token);
+}
+
+
+inline std::string_view before_first(std::string_view sv, std::string_view token)
+{
+  return detail::before_first<std::string_view>(sv, token);
+}
+
+
+inline std::string before_first_copy(std::string_view sv, std::string_view token)
+{
+  return detail::before_first<std::string>(sv, token);
+}
+
+
+inline std::string_view before_last(std::string_view sv, std::string_view token)
+{
+  return detail::before_last<std::string_view>(sv, token);
+}
+
+
+inline std::string before_last_copy(std::string_view sv, std::string_view token)
+{
+  return detail::before_last<std::string>(sv, token);
+}
+
+
+inline std::string_view after_first(std::string_view sv, std::string_view token)
+{
+  return detail::after_first<std::string_view>(sv, token);
+}
+
+
+inline std::string after_first_copy(std::string_view sv, std::string_view token)
+{
+  return detail::after_first<std::string>(sv, token);
+}
+
+
+inline std::string_view after_last(std::string_view sv, std::string_view token)
+{
+  return detail::after_last<std::string_view>(sv, token);
+}
+
+
+inline std::string after_last_copy(std::string_view sv, std::string_view token)
+{
+  return detail::after_last<std::string>(sv, token);
+}
+
+
+inline std::string_view between(std::string_view sv, std::string_view first_token,
+    std::string_view second_token, bool greedy = false)
+{
+  return detail::between<std::string_view>(sv, first_token, second_token, greedy);
+}
+
+
+inline std::string between_copy(std::string_view sv, std::string_view first_token,
+    std::string_view second_token, bool greedy = false)
+{
+  return detail::between<std::string>(sv, first_token, second_token, greedy);
+}
+
+
+inline std::string_view rbetween(std::string_view sv, std::string_view first_token,
+    std::string_view second_token, bool greedy = false)
+{
+  return detail::rbetween<std::string_view>(sv, first_token, second_token, greedy);
+}
+
+
+inline std::string rbetween_copy(std::string_view sv, std::string_view first_token,
+    std::string_view second_token, bool greedy = false)
+{
+  return detail::rbetween<std::string>(sv, first_token, second_token, greedy);
+}
+
+
+inline std::string replace(std::string_view sv, std::string_view search_token,
+    std::string_view replace_token)
+{
+  if (search_token.size() == replace_token.size())
+    return detail::replace_inplace(sv, search_token, replace_token);
+  return detail::replace(sv, search_token, replace_token);
+}
+
+
+// Replaces within s without a second buffer, returns the number of replacements; neither
+// token may refer into s
+inline std::size_t replace_in(std::string& s, std::string_view search_token,
+    std::string_view replace_token)
+{
+  return detail::replace_in(s, search_token, replace_token);
+}
+
+
+// Overloads taking a prepared searcher instead of a token
+//
+
+inline std::vector<std::string_view> split(std::string_view sv, const searcher& token,
+    bool keep_empty_parts = true)
+{
+  if (token.size() == 1)
+    return detail::split_char<std::string_view>(sv, token.token().front(), keep_empty_parts);
+  if (keep_empty_parts)
+    return detail::split_keep_empty<std::string_view, searcher>(sv, token);
+  return detail::split_ignore_empty<std::string_view, searcher>(sv, token);
+}
+
+
+inline std::vector<std::string> split_copy(std::string_view sv, const searcher& token,
+    bool keep_empty_parts = true)
+{
+  if (token.size() == 1)
+    return detail::split_char<std::string>(sv, token.token().front(), keep_empty_parts);
+  if (keep_empty_parts)
+    return detail::split_keep_empty<std::string, searcher>(sv, token);
+  return detail::split_ignore_empty<std::string, searcher>(sv, token);
+}
+
+
+inline void split(std::string_view sv, const searcher& token,
+    std::vector<std::string_view>& parts, bool keep_empty_parts = true)
+{
+  parts.clear();
+  detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(part);
+    return true;
+  });
+}
+
+
+inline void split_copy(std::string_view sv, const searcher& token,
+    std::vector<std::string>& parts, bool keep_empty_parts = true)
+{
+  std::size_t count = 0;
+  detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    if (count < parts.size())
+      parts[count].assign(part);
+    else
+      parts.emplace_back(part);
+    count++;
+    return true;
+  });
+  parts.resize(count);
+}
+
+
+template <typename OutputIt> OutputIt split_to(std::string_view sv, const searcher& token,
+    OutputIt out, bool keep_empty_parts = true)
+{
+  detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    *out++ = part;
+    return true;
+  });
+  return out;
+}
+
+
+template <typename F> bool split_for_each(std::string_view sv, const searcher& token, F fn,
+    bool keep_empty_parts = true)
+{
+  return detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    return detail::invoke_part(fn, part);
+  });
+}
+
+
+inline void split_into_column(std::string_view sv, const searcher& token,
+    string_column& column, bool keep_empty_parts = true)
+{
+  column.clear();
+  column.reserve(0, sv.size());
+  detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    column.push_back(part);
+    return true;
+  });
+}
+
+
+inline string_column split_into_column(std::string_view sv, const searcher& token,
+    bool keep_empty_parts = true)
+{
+  string_column column;
+  split_into_column(sv, token, column, keep_empty_parts);
+  return column;
+}
+
+
+template <std::size_t N> small_vector<std::string_view, N> split_small(std::string_view sv,
+    const searcher& token, bool keep_empty_parts = true)
+{
+  small_vector<std::string_view, N> parts;
+  detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(part);
+    return true;
+  });
+  return parts;
+}
+
+
+inline void split_copy(std::string_view sv, const searcher& token, string_arena& arena,
+    std::vector<std::string_view>& parts, bool keep_empty_parts = true)
+{
+  parts.clear();
+  arena.reserve(sv.size());
+  detail::for_each_part<searcher>(sv, token, keep_empty_parts, [&](std::string_view part) {
+    parts.push_back(arena.copy(part));
+    return true;
+  });
 }
 
 
-template <typename T> T after_last(std::string_view sv, std::string_view token)
+inline std::vector<std::string_view> split_copy(std::string_view sv, const searcher& token,
+    string_arena& arena, bool keep_empty_parts = true)
 {
-  if (auto i = sv.rfind(token); i != std::string_view::npos) {
-    return T{sv.substr(i + token.size())};
-  }
-  return T{};
+  std::vector<std::string_view> parts;
+  split_copy(sv, token, arena, parts, keep_empty_parts);
+  return parts;
 }
 
 
-template <typename T> T between(std::string_view sv, std::string_view first_token,
-    std::string_view second_token, bool greedy = false)
+inline std::tuple<std::string_view, std::string_view> split_first(std::string_view sv,
+    const searcher& token)
 {
-  if (auto i = sv.find(first_token), j = greedy ? sv.rfind(second_token) : sv.find(second_token);
-      i != std::string_view::npos && j != std::string_view::npos && j > i) {
-    return T{sv.substr(i + first_token.size(), j - i - first_token.size())};
-  }
-  return T{};
+  return detail::split_first<std::string_view, searcher>(sv, token);
 }
 
 
-template <typename T> T rbetween(std::string_view sv, std::string_view first_token,
-    std::string_view second_token, bool greedy = false)
+inline std::tuple<std::string, std::string> split_first_copy(std::string_view sv,
+    const searcher& token)
 {
-  if (auto i = sv.rfind(first_token), j = greedy ? sv.find(second_token) : sv.rfind(second_token);
-      i != std::string_view::npos && j != std::string_view::npos && j < i) {
-    return T{sv.substr(j + first_token.size(), i - j - first_token.size())};
-  }
-  return T{};
+  return detail::split_first<std::string, searcher>(sv, token);
 }
 
 
-inline std::string replace(std::string_view sv, std::string_view search_token,
-    std::string_view replace_token)
+inline std::tuple<std::string_view, std::string_view> split_last(std::string_view sv,
+    const searcher& token)
 {
-  std::vector<std::size_t> positions;
-  for (auto p = sv.find(search_token); p != std::string_view::npos;
-      p = sv.find(search_token, p + search_token.size())) {
-    positions.push_back(p);
-  }
-  if (positions.empty())
-    return std::string{sv};
+  return detail::split_last<std::string_view, searcher>(sv, token);
+}
 
-  std::string result;
-  result.resize(sv.size() - search_token.size() * positions.size() +
-      replace_token.size() * positions.size());
-  auto result_it = std::begin(result);
-  auto source_it = std::begin(sv);
-  for (auto p : positions) {
-    result_it = std::copy(source_it, std::begin(sv) + p, result_it);
-    result_it = std::copy(std::begin(replace_token), std::end(replace_token), result_it);
-    source_it = std::begin(sv) + p + search_token.size();
-  }
-  if (result_it != std::end(result)) {
-    std::copy(source_it, std::end(sv), result_it);
-  }
 
-  return result;
+inline std::tuple<std::string, std::string> split_last_copy(std::string_view sv,
+    const searcher& token)
+{
+  return detail::split_last<std::string, searcher>(sv, token);
 }
 
 
-inline std::string replace_inplace(std::string_view sv, std::string_view search_token,
-    std::string_view replace_token)
+inline std::string_view before_first(std::string_view sv, const searcher& token)
 {
-  std::string result{sv};
-  auto result_it = std::begin(result);
-  auto pos = sv.find(search_token);
-  while (pos != std::string_view::npos) {
-    result_it = std::copy(std::begin(replace_token), std::end(replace_token),
-        std::begin(result) + pos);
-    pos = sv.find(search_token, pos + search_token.size());
-  }
-  return result;
+  return detail::before_first<std::string_view, searcher>(sv, token);
 }
 
 
-}  // namepsace nonstd::string_utils::detail
-
+inline std::string before_first_copy(std::string_view sv, const searcher& token)
+{
+  return detail::before_first<std::string, searcher>(sv, token);
+}
 
-// The following functions expect ASCII
-//
 
-namespace nonstd::string_utils::ascii  
+inline std::string_view before_last(std::string_view sv, const searcher& token)
 {
+  return detail::before_last<std::string_view, searcher>(sv, token);
+}
 
 
-inline void to_upper(std::string& s)
+inline std::string before_last_copy(std::string_view sv, const searcher& token)
 {
-  detail::transform(std::begin(s), std::end(s), ::toupper);
+  return detail::before_last<std::string, searcher>(sv, token);
 }
 
 
-inline void to_lower(std::string& s)
+inline std::string_view after_first(std::string_view sv, const searcher& token)
 {
-  detail::transform(std::begin(s), std::end(s), ::tolower);
+  return detail::after_first<std::string_view, searcher>(sv, token);
 }
 
 
-inline std::string as_upper(std::string_view sv)
+inline std::string after_first_copy(std::string_view sv, const searcher& token)
 {
-  std::string s{sv};
-  detail::transform(std::begin(s), std::end(s), ::toupper);
-  return s;
+  return detail::after_first<std::string, searcher>(sv, token);
 }
 
 
-inline std::string as_lower(std::string_view sv)
+inline std::string_view after_last(std::string_view sv, const searcher& token)
 {
-  std::string s{sv};
-  detail::transform(std::begin(s), std::end(s), ::tolower);
-  return s;
+  return detail::after_last<std::string_view, searcher>(sv, token);
 }
 
 
-}  // namespace nonstd::string_utils::ascii
+inline std::string after_last_copy(std::string_view sv, const searcher& token)
+{
+  return detail::after_last<std::string, searcher>(sv, token);
+}
 
 
-namespace nonstd::string_utils
+inline std::string_view between(std::string_view sv, const searcher& first_token,
+    const searcher& second_token, bool greedy = false)
 {
+  return detail::between<std::string_view, searcher>(sv, first_token, second_token, greedy);
+}
 
 
-// The following functions are not Unicode aware and simply do byte comparisons
-//
-
-inline bool starts_with(std::string_view sv, std::string_view test)
+inline std::string between_copy(std::string_view sv, const searcher& first_token,
+    const searcher& second_token, bool greedy = false)
 {
-  if (sv.empty() || test.empty() || test.size() > sv.size())
-    return false;
-  return detail::compare(std::begin(sv), std::begin(test), std::end(test));
+  return detail::between<std::string, searcher>(sv, first_token, second_token, greedy);
 }
 
 
-inline bool ends_with(std::string_view sv, std::string_view test)
+inline std::string_view rbetween(std::string_view sv, const searcher& first_token,
+    const searcher& second_token, bool greedy = false)
 {
-  if (sv.empty() || test.empty() || test.size() > sv.size())
-    return false;
-  return detail::compare(std::rbegin(sv), std::rbegin(test), std::rend(test));
+  return detail::rbetween<std::string_view, searcher>(sv, first_token, second_token, greedy);
 }
 
 
-inline std::vector<std::string_view> split(std::string_view sv,
-    std::string_view token, bool keep_empty_parts = true)
+inline std::string rbetween_copy(std::string_view sv, const searcher& first_token,
+    const searcher& second_token, bool greedy = false)
 {
-  if (keep_empty_parts)
-    return detail::split_keep_empty<std::string_view>(sv, token);
-  return detail::split_ignore_empty<std::string_view>(sv, token);
+  return detail::rbetween<std::string, searcher>(sv, first_token, second_token, greedy);
 }
 
 
-inline std::vector<std::string> split_copy(std::string_view sv,
-    std::string_view token, bool keep_empty_parts = true)
+inline std::string replace(std::string_view sv, const searcher& search_token,
+    std::string_view replace_token)
 {
-  if (keep_empty_parts)
-    return detail::split_keep_empty<std::string>(sv, token);
-  return detail::split_ignore_empty<std::string>(sv, token);
+  if (search_token.size() == replace_token.size())
+    return detail::replace_inplace<searcher>(sv, search_token, replace_token);
+  return detail::replace<searcher>(sv, search_token, replace_token);
 }
 
 
-inline std::vector<std::string_view> split_chars(std::string_view sv,
-    std::size_t char_count, std::size_t skip = 0)
+inline std::size_t replace_in(std::string& s, const searcher& search_token,
+    std::string_view replace_token)
 {
-  return detail::split_chars<std::string_view>(sv, char_count, skip);
+  return detail::replace_in<searcher>(s, search_token, replace_token);
 }
 
 
-inline std::vector<std::string> split_chars_copy(std::string_view sv,
-  std::size_t char_count, std::size_t skip = 0)
+// Overloads taking the allocator for the results, tokens may be string views or searchers.
+// With std::pmr::polymorphic_allocator<char> the results are std::pmr::string and
+// std::pmr::vector<std::pmr::string> allocated from its memory resource
+//
+
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_strings_t<Allocator> split_copy(std::string_view sv, const Token& token,
+    const Allocator& alloc, bool keep_empty_parts = true)
 {
-  return detail::split_chars<std::string>(sv, char_count, skip);
+  detail::basic_strings_t<Allocator> parts(alloc);
+  split_for_each(sv, token, [&](std::string_view part) {
+    parts.emplace_back(detail::basic_string_t<Allocator>{part, alloc});
+  }, keep_empty_parts);
+  return parts;
 }
 
 
-inline std::tuple<std::string_view, std::string_view> split_first(std::string_view sv,
-    std::string_view token)
+template <typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_strings_t<Allocator> split_chars_copy(std::string_view sv,
+    std::size_t char_count, std::size_t skip, const Allocator& alloc)
 {
-  return detail::split_first<std::string_view>(sv, token);
+  detail::basic_strings_t<Allocator> parts(alloc);
+  split_chars_for_each(sv, char_count, skip, [&](std::string_view part) {
+    parts.emplace_back(detail::basic_string_t<Allocator>{part, alloc});
+  });
+  return parts;
 }
 
 
-inline std::tuple<std::string, std::string> split_first_copy(std::string_view sv,
-    std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+std::tuple<detail::basic_string_t<Allocator>, detail::basic_string_t<Allocator>>
+split_first_copy(std::string_view sv, const Token& token, const Allocator& alloc)
 {
-  return detail::split_first<std::string>(sv, token);
+  auto [first, second] = split_first(sv, token);
+  return {detail::basic_string_t<Allocator>{first, alloc},
+      detail::basic_string_t<Allocator>{second, alloc}};
 }
 
 
-inline std::tuple<std::string_view, std::string_view> split_last(std::string_view sv,
-    std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+std::tuple<detail::basic_string_t<Allocator>, detail::basic_string_t<Allocator>>
+split_last_copy(std::string_view sv, const Token& token, const Allocator& alloc)
 {
-  return detail::split_last<std::string_view>(sv, token);
+  auto [first, second] = split_last(sv, token);
+  return {detail::basic_string_t<Allocator>{first, alloc},
+      detail::basic_string_t<Allocator>{second, alloc}};
 }
 
 
-inline std::tuple<std::string, std::string> split_last_copy(std::string_view sv,
-    std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> before_first_copy(std::string_view sv, const Token& token,
+    const Allocator& alloc)
 {
-  return detail::split_last<std::string>(sv, token);
+  return detail::basic_string_t<Allocator>{before_first(sv, token), alloc};
 }
 
 
-inline std::string_view before_first(std::string_view sv, std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> before_last_copy(std::string_view sv, const Token& token,
+    const Allocator& alloc)
 {
-  return detail::before_first<std::string_view>(sv, token);
+  return detail::basic_string_t<Allocator>{before_last(sv, token), alloc};
 }
 
 
-inline std::string before_first_copy(std::string_view sv, std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> after_first_copy(std::string_view sv, const Token& token,
+    const Allocator& alloc)
 {
-  return detail::before_first<std::string>(sv, token);
+  return detail::basic_string_t<Allocator>{after_first(sv, token), alloc};
 }
 
 
-inline std::string_view before_last(std::string_view sv, std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> after_last_copy(std::string_view sv, const Token& token,
+    const Allocator& alloc)
 {
-  return detail::before_last<std::string_view>(sv, token);
+  return detail::basic_string_t<Allocator>{after_last(sv, token), alloc};
 }
 
 
-inline std::string before_last_copy(std::string_view sv, std::string_view token)
+template <typename First, typename Second, typename Allocator,
+    typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> between_copy(std::string_view sv, const First& first_token,
+    const Second& second_token, const Allocator& alloc, bool greedy = false)
 {
-  return detail::before_last<std::string>(sv, token);
+  return detail::basic_string_t<Allocator>{between(sv, first_token, second_token, greedy),
+      alloc};
 }
 
 
-inline std::string_view after_first(std::string_view sv, std::string_view token)
+template <typename First, typename Second, typename Allocator,
+    typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> rbetween_copy(std::string_view sv, const First& first_token,
+    const Second& second_token, const Allocator& alloc, bool greedy = false)
 {
-  return detail::after_first<std::string_view>(sv, token);
+  return detail::basic_string_t<Allocator>{rbetween(sv, first_token, second_token, greedy),
+      alloc};
 }
 
 
-inline std::string after_first_copy(std::string_view sv, std::string_view token)
+template <typename Token, typename Allocator, typename = detail::if_char_allocator_t<Allocator>>
+detail::basic_string_t<Allocator> replace(std::string_view sv, const Token& search_token,
+    std::string_view replace_token, const Allocator& alloc)
 {
-  return detail::after_first<std::string>(sv, token);
+  using token_type = std::conditional_t<std::is_same_v<Token, searcher>, searcher,
+      std::string_view>;
+  const token_type& token = search_token;
+  if (token.size() == replace_token.size())
+    return detail::replace_inplace<token_type>(sv, token, replace_token, alloc);
+  return detail::replace<token_type>(sv, token, replace_token, alloc);
 }
 
 
-inline std::string_view after_last(std::string_view sv, std::string_view token)
+// Replaces several tokens in a single pass. The tokens form an Aho-Corasick automaton over
+// the bytes they use; of overlapping matches the leftmost wins, then the longest. Empty
+// search tokens are ignored and the first of duplicate ones is used
+//
+
+class multi_replacer
 {
-  return detail::after_last<std::string_view>(sv, token);
-}
+public:
+  multi_replacer(std::initializer_list<std::pair<std::string_view, std::string_view>> tokens)
+  {
+    build(tokens);
+  }
 
 
-inline std::string after_last_copy(std::string_view sv, std::string_view token)
+  // Any range of pairs of search token and replacement
+  template <typename Range> explicit multi_replacer(const Range& tokens)
+  {
+    build(tokens);
+  }
+
+
+  // The result is allocated once. Without longer replacements it is as large as the input,
+  // otherwise a first pass adds up the exact size and keeps a small batch of matches; the
+  // input is only matched again when there were more
+  std::string replace(std::string_view sv) const
+  {
+    constexpr std::size_t batch_size = 64;
+    std::array<std::pair<std::size_t, std::uint32_t>, batch_size> batch;
+    std::size_t count = 0;
+    auto size = sv.size();
+    if (grows_) {
+      for_each_match(sv, [&](std::size_t pos, std::uint32_t token) {
+        if (count < batch_size)
+          batch[count] = {pos, token};
+        count++;
+        size += replacements_[token].size();
+        size -= sizes_[token];
+      });
+    }
+
+    std::string result;
+    result.reserve(size);
+    std::size_t start = 0;
+    auto append = [&](std::size_t pos, std::uint32_t token) {
+      result.append(sv.data() + start, pos - start);
+      result += replacements_[token];
+      start = pos + sizes_[token];
+    };
+    if (grows_ && count <= batch_size) {
+      for (std::size_t i = 0; i < count; i++)
+        append(batch[i].first, batch[i].second);
+    }
+    else {
+      for_each_match(sv, append);
+    }
+    result.append(sv.data() + start, sv.size() - start);
+    return result;
+  }
+
+private:
+  static constexpr std::uint32_t no_match = ~std::uint32_t{0};
+  static constexpr std::uint32_t match_flag = std::uint32_t{1} << 31;
+
+  std::size_t class_of(char c) const { return classes_[static_cast<unsigned char>(c)]; }
+
+
+  // A trie over byte classes, only the bytes used by the tokens get a class of their own
+  template <typename Range> void build(const Range& tokens)
+  {
+    for (const auto& [search, replacement] : tokens) {
+      if (std::string_view{search}.empty())
+        continue;
+      for (char c : std::string_view{search}) {
+        auto& cls = classes_[static_cast<unsigned char>(c)];
+        if (cls == 0)
+          cls = static_cast<std::uint16_t>(class_count_++);
+      }
+      if (first_bytes_.find(std::string_view{search}.front()) == std::string::npos)
+        first_bytes_ += std::string_view{search}.front();
+      max_size_ = std::max(max_size_, std::string_view{search}.size());
+    }
+
+    transitions_.assign(class_count_, 0);
+    matches_.push_back(no_match);
+    for (const auto& [search, replacement] : tokens) {
+      std::string_view token{search};
+      if (token.empty())
+        continue;
+      std::uint32_t state = 0;
+      for (char c : token) {
+        auto next = transitions_[state * class_count_ + class_of(c)];
+        if (next == 0) {
+          next = static_cast<std::uint32_t>(matches_.size());
+          transitions_[state * class_count_ + class_of(c)] = next;
+          transitions_.resize(transitions_.size() + class_count_, 0);
+          matches_.push_back(no_match);
+        }
+        state = next;
+      }
+      if (matches_[state] == no_match) {
+        matches_[state] = static_cast<std::uint32_t>(sizes_.size());
+        sizes_.push_back(token.size());
+        replacements_.emplace_back(replacement);
+        grows_ = grows_ || replacements_.back().size() > token.size();
+      }
+    }
+    build_links();
+  }
+
+
+  // Breadth first, missing transitions are taken from the failure state and every state
+  // reports the longest token that ends in it. Transitions are stored as the offset of the
+  // target row, flagged when the target reports a token
+  void build_links()
+  {
+    std::vector<std::uint32_t> fail(matches_.size(), 0);
+    std::vector<std::uint32_t> queue;
+    for (std::size_t c = 0; c < class_count_; c++) {
+      if (auto next = transitions_[c]; next != 0)
+        queue.push_back(next);
+    }
+    for (std::size_t head = 0; head < queue.size(); head++) {
+      auto state = queue[head];
+      if (matches_[state] == no_match)
+        matches_[state] = matches_[fail[state]];
+      for (std::size_t c = 0; c < class_count_; c++) {
+        auto& next = transitions_[state * class_count_ + c];
+        auto fallback = transitions_[fail[state] * class_count_ + c];
+        if (next != 0) {
+          fail[next] = fallback;
+          queue.push_back(next);
+        }
+        else {
+          next = fallback;
+        }
+      }
+    }
+    for (auto& next : transitions_) {
+      auto flag = matches_[next] != no_match ? match_flag : 0;
+      next = static_cast<std::uint32_t>(next * class_count_) | flag;
+    }
+  }
+
+
+  // Calls func with the position and token of every match to replace, in order. The
+  // automaton runs from each byte that can start a token until it is back at the root, and
+  // a match is only final once no token starting at or before it can still end later
+  template <typename F> void for_each_match(std::string_view sv, F func) const
+  {
+    const char* p = sv.data();
+    const std::size_t size = sv.size();
+    std::size_t i = 0;
+
+    detail::for_each_any_of(sv, first_bytes_, [&](std::size_t candidate) {
+      if (candidate < i)
+        return true;
+      i = candidate;
+      std::uint32_t row = 0;
+      std::size_t best_start = 0;
+      std::size_t best_end = 0;
+      std::uint32_t best = no_match;
+      do {
+        row = transitions_[row + class_of(p[i++])];
+        if (row & match_flag) {
+          row &= ~match_flag;
+          auto token = matches_[row / class_count_];
+          auto start = i - sizes_[token];
+          if (best == no_match || start < best_start || (start == best_start && i > best_end)) {
+            best_start = start;
+            best_end = i;
+            best = token;
+          }
+        }
+        if (best != no_match && (i == size || i >= best_start + max_size_)) {
+          func(best_start, best);
+          i = best_end;
+          row = 0;
+          best = no_match;
+        }
+      } while ((row != 0 || best != no_match) && i < size);
+      return true;
+    });
+  }
+
+  std::array<std::uint16_t, 256> classes_{};
+  std::string first_bytes_;
+  std::size_t class_count_ = 1;
+  std::size_t max_size_ = 0;
+  std::vector<std::uint32_t> transitions_;
+  std::vector<std::uint32_t> matches_;
+  std::vector<std::size_t> sizes_;
+  std::vector<std::string> replacements_;
+  bool grows_ = false;
+};
+
+
+inline std::string replace_all(std::string_view sv, const multi_replacer& replacer)
 {
-  return detail::after_last<std::string>(sv, token);
+  return replacer.replace(sv);
 }
 
 
-inline std::string_view between(std::string_view sv, std::string_view first_token,
-    std::string_view second_token, bool greedy = false)
+inline std::string replace_all(std::string_view sv,
+    std::initializer_list<std::pair<std::string_view, std::string_view>> tokens)
 {
-  return detail::between<std::string_view>(sv, first_token, second_token, greedy);
+  return multi_replacer{tokens}.replace(sv);
 }
 
 
-inline std::string between_copy(std::string_view sv, std::string_view first_token,
-    std::string_view second_token, bool greedy = false)
+// Replaces a token in input that arrives in chunks, matches may span any number of chunks.
+// Output is passed to func as views that are only valid during the call, or appended to a
+// string. At most search_token.size() - 1 bytes are held back between chunks
+//
+
+class stream_replacer
 {
-  return detail::between<std::string>(sv, first_token, second_token, greedy);
-}
+public:
+  stream_replacer(std::string_view search_token, std::string_view replace_token)
+    : searcher_{search_token}, replacement_{replace_token}
+  {
+  }
 
 
-inline std::string_view rbetween(std::string_view sv, std::string_view first_token,
-    std::string_view second_token, bool greedy = false)
+  template <typename F> void feed(std::string_view chunk, F func)
+  {
+    const auto m = searcher_.size();
+    if (m <= 1 || (carry_.empty() && chunk.size() >= m - 1)) {
+      carry_.assign(chunk.substr(scan(chunk, 0, func)));
+      return;
+    }
+    if (chunk.size() < m - 1) {
+      carry_ += chunk;
+      carry_.erase(0, scan(carry_, 0, func));
+      return;
+    }
+
+    // Only matches that start in the held back bytes are taken from them joined with the
+    // start of the chunk, the rest of the chunk is scanned where it is
+    const auto held = carry_.size();
+    carry_ += chunk.substr(0, m - 1);
+    std::size_t i = 0;
+    for (auto p = searcher_.find(carry_); p < held; p = searcher_.find(carry_, i)) {
+      emit(std::string_view{carry_}.substr(i, p - i), func);
+      emit(replacement_, func);
+      i = p + m;
+    }
+    if (i < held)
+      emit(std::string_view{carry_}.substr(i, held - i), func);
+    carry_.assign(chunk.substr(scan(chunk, i > held ? i - held : 0, func)));
+  }
+
+
+  // Passes on the bytes held back, the replacer can then be fed new input
+  template <typename F> void finish(F func)
+  {
+    emit(carry_, func);
+    carry_.clear();
+  }
+
+
+  void feed(std::string_view chunk, std::string& out)
+  {
+    feed(chunk, [&](std::string_view sv) { out += sv; });
+  }
+
+
+  void finish(std::string& out)
+  {
+    finish([&](std::string_view sv) { out += sv; });
+  }
+
+private:
+  template <typename F> static void emit(std::string_view sv, F& func)
+  {
+    if (!sv.empty())
+      func(sv);
+  }
+
+
+  // Replaces matches in sv from pos on and returns where the bytes that could still be the
+  // start of a match begin
+  template <typename F> std::size_t scan(std::string_view sv, std::size_t pos, F& func) const
+  {
+    const auto m = searcher_.size();
+    if (m == 0) {
+      emit(sv.substr(pos), func);
+      return sv.size();
+    }
+    auto i = pos;
+    for (auto p = searcher_.find(sv, i); p != std::string_view::npos; p = searcher_.find(sv, i)) {
+      emit(sv.substr(i, p - i), func);
+      emit(replacement_, func);
+      i = p + m;
+    }
+    auto keep = std::max(i, sv.size() >= m - 1 ? sv.size() - (m - 1) : 0);
+    emit(sv.substr(i, keep - i), func);
+    return keep;
+  }
+
+  searcher searcher_;
+  std::string replacement_;
+  std::string carry_;
+};
+
+
+// Splits input that arrives in chunks into the same parts as split() on all of it. Parts
+// within a chunk are passed to func as views into it, only parts spanning chunks are
+// gathered in a buffer and those views are valid during the call
+//
+
+class tokenizer
 {
-  return detail::rbetween<std::string_view>(sv, first_token, second_token, greedy);
-}
+public:
+  explicit tokenizer(std::string_view token, bool keep_empty_parts = true)
+    : token_{token}, keep_empty_parts_{keep_empty_parts}
+  {
+  }
 
 
-inline std::string rbetween_copy(std::string_view sv, std::string_view first_token,
-    std::string_view second_token, bool greedy = false)
+  template <typename F> void feed(std::string_view chunk, F func)
+  {
+    const auto m = token_.size();
+    if (m == 0) {
+      partial_ += chunk;
+      return;
+    }
+
+    // A part is pending, its end is found where a token may start in its last bytes
+    std::size_t start = 0;
+    if (!partial_.empty()) {
+      const auto held = partial_.size();
+      auto p = std::string_view::npos;
+      if (m > 1) {
+        partial_ += chunk.substr(0, m - 1);
+        p = token_.find(partial_, held > m - 1 ? held - (m - 1) : 0);
+        partial_.resize(held);
+      }
+      if (p == std::string_view::npos) {
+        if (p = token_.find(chunk); p == std::string_view::npos) {
+          partial_ += chunk;
+          return;
+        }
+        p += held;
+      }
+      if (p > held)
+        partial_.append(chunk.substr(0, p - held));
+      emit(std::string_view{partial_}.substr(0, p), func);
+      partial_.clear();
+      start = p + m - held;
+    }
+
+    for (auto i = token_.find(chunk, start); i != std::string_view::npos;
+        i = token_.find(chunk, start)) {
+      emit(chunk.substr(start, i - start), func);
+      start = i + m;
+    }
+    partial_.assign(chunk.substr(start));
+  }
+
+
+  // Passes on the last part, the tokenizer can then be fed new input
+  template <typename F> void finish(F func)
+  {
+    emit(partial_, func);
+    partial_.clear();
+  }
+
+private:
+  template <typename F> void emit(std::string_view part, F& func) const
+  {
+    if (keep_empty_parts_ || !part.empty())
+      func(part);
+  }
+
+  searcher token_;
+  bool keep_empty_parts_;
+  std::string partial_;
+};
+
+
+// Exactly N decimal digits, no sign or other characters, parsed eight at a time; returns
+// 0 for anything else or values that do not fit
+//
+
+template <std::size_t N> std::uint32_t as_uint32_fixed(std::string_view sv)
 {
-  return detail::rbetween<std::string>(sv, first_token, second_token, greedy);
+  std::uint32_t value = 0;
+  if (sv.size() != N || !detail::parse_fixed<std::uint32_t, N>(sv.data(), value))
+    return 0;
+  return value;
 }
 
 
-inline std::string replace(std::string_view sv, std::string_view search_token,
-    std::string_view replace_token)
+template <std::size_t N> std::uint64_t as_uint64_fixed(std::string_view sv)
 {
-  if (search_token.size() == replace_token.size())
-    return detail::replace_inplace(sv, search_token, replace_token);
-  return detail::replace(sv, search_token, replace_token);
+  std::uint64_t value = 0;
+  if (sv.size() != N || !detail::parse_fixed<std::uint64_t, N>(sv.data(), value))
+    return 0;
+  return value;
 }
 
 
@@ -497,43 +4989,51 @@ inline std::string replace(std::string_view sv, std::string_view search_token,
     return detail::parse_number<std::int64_t>(sv, base);
   }
 
-  
-  #ifdef NONSTD_STRING_UTILS_CHARCONV_INTEGRAL_TYPES_ONLY
-    inline float as_float(std::string_view sv)
-    {
-      return std::stof(std::string{sv});
-    }
-
 
-    inline double as_double(std::string_view sv)
-    {
-      return std::stod(std::string{sv});
-    }
+  // Parses every field of a delimited list of numbers into out, stops at the first
+  // malformed or empty field
+  template <typename T, typename OutputIt> parse_result parse_delimited(std::string_view sv,
+      char delimiter, OutputIt out)
+  {
+    static_assert(std::is_integral_v<T> || std::is_same_v<T, float> ||
+        std::is_same_v<T, double>, "parse_delimited expects an integral, float or double type");
+    return detail::parse_delimited<T>(sv, delimiter, out);
+  }
 
 
+  #ifdef NONSTD_STRING_UTILS_CHARCONV_INTEGRAL_TYPES_ONLY
     inline long double as_longdouble(std::string_view sv)
     {
-      return std::stold(std::string{sv});
+      if constexpr (sizeof(long double) == sizeof(double))
+        return detail::parse_float<double>(sv);
+      else
+        return std::stold(std::string{sv});
     }
   #else
-    inline float as_float(std::string_view sv)
+    inline long double as_longdouble(std::string_view sv)
     {
-      return detail::parse_number<float>(sv);
+      long double value = 0;
+      std::from_chars(sv.data(), sv.data() + sv.size(), value);
+      return value;
     }
+  #endif
+#endif  // NONSTD_STRING_UTILS_CHARCONV
 
 
-    inline double as_double(std::string_view sv)
-    {
-      return detail::parse_number<double>(sv);
-    }
+// Correctly rounded and independent of the locale, nothing is allocated or thrown; returns
+// 0 for malformed input and for values out of range
+//
+
+inline float as_float(std::string_view sv)
+{
+  return detail::parse_float<float>(sv);
+}
 
 
-    inline long double as_longdouble(std::string_view sv)
-    {
-      return detail::parse_number<long double>(sv);
-    }
-  #endif
-#endif  // NONSTD_STRING_UTILS_CHARCONV
+inline double as_double(std::string_view sv)
+{
+  return detail::parse_float<double>(sv);
+}
 
 
 }  // namespace nonstd::string_utils
@@ -1,5 +1,12 @@
 #include "../string_utils.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <limits>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
@@ -36,6 +43,19 @@ TEST_CASE("ascii case functions") {
     CHECK(ascii::as_lower("abc_XYZ,-$") == "abc_xyz,-$");
     CHECK(ascii::as_lower("") == "");
   }
+
+  SUBCASE("into a buffer") {
+    char buffer[64];
+    CHECK(ascii::as_upper("Content-Type: text/plain; charset=\xC3\xA9", buffer) ==
+        "CONTENT-TYPE: TEXT/PLAIN; CHARSET=\xC3\xA9");
+    CHECK(ascii::as_lower("Content-Type: text/plain; charset=\xC3\x89", buffer) ==
+        "content-type: text/plain; charset=\xC3\x89");
+    CHECK(ascii::as_lower("", buffer).empty());
+
+    auto s = std::string{"X-Forwarded-For"};
+    CHECK(ascii::as_lower(s, s.data()) == "x-forwarded-for");
+    CHECK(s == "x-forwarded-for");
+  }
 }
 
 
@@ -335,6 +355,711 @@ TEST_CASE("split ignore empty") {
 }
 
 
+TEST_CASE("split with a token known at compile time") {
+  using namespace nonstd::string_utils;
+
+  CHECK(split<','>("a,b,,c") == std::vector<std::string_view>{"a", "b", "", "c"});
+  CHECK(split<','>("a,b,,c", false) == std::vector<std::string_view>{"a", "b", "c"});
+  CHECK(split<'\r', '\n'>("one\r\ntwo\r\n") ==
+      std::vector<std::string_view>{"one", "two", ""});
+  CHECK(split_copy<'-', '-', '>'>("a-->b--->c") == std::vector<std::string>{"a", "b-", "c"});
+  CHECK(split<'a', 'a'>("aaaaa") == split("aaaaa", "aa"));
+  CHECK(split<'a', 'b', 'a'>("abababa") == split("abababa", "aba"));
+  CHECK(split<'x', 'y'>("") == std::vector<std::string_view>{""});
+  CHECK(split<'x', 'y', 'z'>("xy") == std::vector<std::string_view>{"xy"});
+
+  std::vector<std::string_view> seen;
+  CHECK(!split_for_each<':', ':'>("a::b::c", [&](std::string_view part) {
+    seen.push_back(part);
+    return part != "b";
+  }));
+  CHECK(seen == std::vector<std::string_view>{"a", "b"});
+  CHECK(split_for_each<'/'>("/usr/lib", [](std::string_view) {}, false));
+
+  // Same parts as split around every block boundary and at every simd level
+  std::string text;
+  for (int i = 0; i < 400; i++) {
+    text += std::string(static_cast<std::size_t>(i * 7 % 23), 'a');
+    text += i % 3 == 0 ? "<=>" : i % 3 == 1 ? "<=" : ",";
+  }
+  const auto initial = active_simd_level();
+  for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2,
+      simd_level::avx512bw}) {
+    if (level > detected_simd_level())
+      break;
+    set_simd_level(level);
+    auto level_value = static_cast<int>(level);
+    CAPTURE(level_value);
+    for (std::size_t size = 0; size < 300; size++) {
+      auto sv = std::string_view{text}.substr(0, size);
+      CHECK(split<','>(sv) == split(sv, ","));
+      CHECK(split<'<', '='>(sv, false) == split(sv, "<=", false));
+      CHECK(split<'<', '=', '>'>(sv) == split(sv, "<=>"));
+      CHECK(split<'a', 'a'>(sv) == split(sv, "aa"));
+      CHECK(split<'a', 'a', 'a', 'a', 'a'>(sv) == split(sv, "aaaaa"));
+    }
+    CHECK(split<'=', '>', 'a'>(text) == split(text, "=>a"));
+  }
+  set_simd_level(initial);
+}
+
+
+TEST_CASE("split at char") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("1") {
+    auto v = split(",bb,cc,", ',');
+    CHECK(v.size() == 4);
+    CHECK(v[0].empty());
+    CHECK(v[1] == "bb");
+    CHECK(v[2] == "cc");
+    CHECK(v[3].empty());
+    CHECK(split(",bb,cc,", ',', false) == std::vector<std::string_view>{"bb", "cc"});
+    CHECK(split_copy("a,b", ',') == std::vector<std::string>{"a", "b"});
+  }
+
+  SUBCASE("same parts as the substring search") {
+    // Lengths around the 16 and 32 byte blocks, delimiters at the block edges
+    std::string s;
+    for (int n = 0; n < 100; n++) {
+      s += (n % 3 == 0 || n % 16 == 15 || n % 32 == 0) ? ',' : static_cast<char>('a' + n % 26);
+      for (bool keep_empty_parts : {true, false}) {
+        auto expected = keep_empty_parts ?
+            detail::split_keep_empty<std::string_view>(s, ",") :
+            detail::split_ignore_empty<std::string_view>(s, ",");
+        CHECK(split(s, ',', keep_empty_parts) == expected);
+        CHECK(split(s, ",", keep_empty_parts) == expected);
+      }
+    }
+  }
+}
+
+
+TEST_CASE("lines") {
+  using namespace nonstd::string_utils;
+  auto collect = [](std::string_view sv) {
+    std::vector<std::string_view> v;
+    for (auto line : lines(sv))
+      v.push_back(line);
+    return v;
+  };
+
+  CHECK(collect("").empty());
+  CHECK(collect("one") == std::vector<std::string_view>{"one"});
+  CHECK(collect("one\n") == std::vector<std::string_view>{"one"});
+  CHECK(collect("one\r\ntwo\n\nthree") == std::vector<std::string_view>{"one", "two", "",
+      "three"});
+  CHECK(collect("\n\r\n") == std::vector<std::string_view>{"", ""});
+  CHECK(collect("a\rb\n") == std::vector<std::string_view>{"a\rb"});
+
+  auto view = lines("x\ny");
+  CHECK(std::distance(view.begin(), view.end()) == 2);
+  CHECK(view.begin() == view.begin());
+  CHECK(++view.begin() != view.begin());
+
+  std::vector<std::string_view> kept;
+  for (auto line : lines("one\r\ntwo\r", false))
+    kept.push_back(line);
+  CHECK(kept == std::vector<std::string_view>{"one\r", "two\r"});
+
+  // Lines of every length around the 64 byte blocks, at every simd level
+  std::string text;
+  for (int i = 0; i < 200; i++) {
+    text += std::string(static_cast<std::size_t>(i * 7 % 150), static_cast<char>('a' + i % 26));
+    text += i % 5 ? "\n" : "\r\n";
+  }
+  auto expected = split(text, "\n");
+  expected.pop_back();
+  for (auto& line : expected) {
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+  }
+  const auto initial = active_simd_level();
+  for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2,
+      simd_level::avx512bw}) {
+    if (level > detected_simd_level())
+      break;
+    set_simd_level(level);
+    auto level_value = static_cast<int>(level);
+    CAPTURE(level_value);
+    for (std::size_t n : {text.size(), text.size() - 1, std::size_t{64}, std::size_t{65}}) {
+      auto sv = std::string_view{text}.substr(0, n);
+      std::vector<std::string_view> reference;
+      for (auto part : split_view{sv, "\n"}) {
+        if (!part.empty() && part.back() == '\r')
+          part.remove_suffix(1);
+        reference.push_back(part);
+      }
+      if (sv.back() == '\n')
+        reference.pop_back();
+      CHECK(collect(sv) == reference);
+    }
+    CHECK(collect(text) == expected);
+  }
+  set_simd_level(initial);
+}
+
+
+TEST_CASE("parallel_split") {
+  using namespace nonstd::string_utils;
+
+  std::string text;
+  for (int i = 0; i < 100000; i++)
+    text += i % 7 == 0 ? ",," : (i % 3 == 0 ? "::" : "ab,");
+  for (auto token : {",", "::", ",a", "b,,"}) {
+    for (bool keep_empty : {true, false}) {
+      auto expected = split(text, token, keep_empty);
+      for (std::size_t threads : {0, 1, 2, 3, 8}) {
+        CAPTURE(token);
+        CAPTURE(threads);
+        CHECK(parallel_split(text, token, threads, keep_empty) == expected);
+      }
+    }
+  }
+
+  // Tokens that overlap themselves and small inputs are split on one thread
+  const std::string repeated(300001, 'a');
+  CHECK(parallel_split(repeated, "aa", 4) == split(repeated, "aa"));
+  CHECK(parallel_split("a,b", ",", 4) == std::vector<std::string_view>{"a", "b"});
+  CHECK(parallel_split("", ",", 4) == std::vector<std::string_view>{""});
+}
+
+
+TEST_CASE("csv_reader") {
+  using namespace nonstd::string_utils;
+
+  auto read = [](std::string_view sv, char delimiter = ',') {
+    csv_reader reader{sv, delimiter};
+    std::vector<csv_field> fields;
+    std::vector<std::vector<std::string>> records;
+    while (reader.read_record(fields)) {
+      records.emplace_back();
+      for (const auto& field : fields)
+        records.back().push_back(field.value_copy());
+    }
+    return records;
+  };
+  using records = std::vector<std::vector<std::string>>;
+
+  SUBCASE("quoting") {
+    CHECK(read("a,b,c\n1,\"x, y\",3\n") == records{{"a", "b", "c"}, {"1", "x, y", "3"}});
+    CHECK(read("\"multi\nline\",\"say \"\"hi\"\"\"\r\nlast") ==
+        records{{"multi\nline", "say \"hi\""}, {"last"}});
+    CHECK(read("\"\",,\"\"\"\"\n") == records{{"", "", "\""}});
+    CHECK(read("a;\"b;c\"", ';') == records{{"a", "b;c"}});
+  }
+
+  SUBCASE("malformed quoting") {
+    // Quotes inside of a field are data, parsing goes on at the next line break
+    CHECK(read("5\" monitor,12\nnext,row\nthird,x\n") ==
+        records{{"5\" monitor", "12"}, {"next", "row"}, {"third", "x"}});
+    CHECK(read("x\"y,\"p,q\"\n\"a\"b,c\n") == records{{"x\"y", "p,q"}, {"\"a\"b", "c"}});
+    // A quoted field that is never closed holds the rest of the input
+    CHECK(read("\"unterminated,x\ny,z\n") == records{{"\"unterminated,x\ny,z\n"}});
+  }
+
+  SUBCASE("quotes at block boundaries") {
+    const std::string doubled = "\"" + std::string(62, 'a') + "\"\"b\",c\n";
+    CHECK(read(doubled) == records{{std::string(62, 'a') + "\"b", "c"}});
+    const std::string opening = std::string(63, 'x') + ",\"p,q\"\n";
+    CHECK(read(opening) == records{{std::string(63, 'x'), "p,q"}});
+  }
+
+  SUBCASE("records") {
+    CHECK(read("").empty());
+    CHECK(read("\n") == records{{""}});
+    CHECK(read("a\r\n\r\nb") == records{{"a"}, {""}, {"b"}});
+    CHECK(read("a,") == records{{"a", ""}});
+  }
+
+  SUBCASE("fields are views") {
+    std::string_view text = "plain,\"quoted\",\"esc\"\"aped\"";
+    csv_reader reader{text};
+    std::vector<csv_field> fields;
+    REQUIRE(reader.read_record(fields));
+    REQUIRE(fields.size() == 3);
+    CHECK(fields[0].raw.data() == text.data());
+    CHECK(!fields[1].escaped);
+    CHECK(fields[1].raw == "quoted");
+    CHECK(fields[2].escaped);
+    CHECK(fields[2].raw == "esc\"\"aped");
+    std::string buffer;
+    CHECK(fields[1].value(buffer).data() == fields[1].raw.data());
+    CHECK(fields[2].value(buffer) == "esc\"aped");
+    CHECK(!reader.read_record(fields));
+    CHECK(fields.empty());
+  }
+
+  SUBCASE("quotes across blocks") {
+    // Quoted fields with delimiters and line breaks that span the 64 byte blocks
+    std::string text;
+    records expected;
+    for (int i = 0; i < 50; i++) {
+      std::string value(static_cast<std::size_t>(i * 13 % 90), ',');
+      value += i % 2 ? "\n\"" : "x";
+      text += std::to_string(i) + ",\"" + replace(value, "\"", "\"\"") + "\"\n";
+      expected.push_back({std::to_string(i), value});
+    }
+    const auto initial = active_simd_level();
+    for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2,
+        simd_level::avx512bw}) {
+      if (level > detected_simd_level())
+        break;
+      set_simd_level(level);
+      auto level_value = static_cast<int>(level);
+      CAPTURE(level_value);
+      CHECK(read(text) == expected);
+    }
+    set_simd_level(initial);
+  }
+}
+
+
+TEST_CASE("delimiter_index") {
+  using namespace nonstd::string_utils;
+
+  const std::string_view text = "a,b;;c,,\nlast";
+  delimiter_index index{text, ",;\n"};
+  CHECK(index.count() == 6);
+  CHECK(index.position(0) == 1);
+  CHECK(index.position(5) == 8);
+  CHECK(index.part(0) == "a");
+  CHECK(index.part(3) == "c");
+  CHECK(index.part(4) == "");
+  CHECK(index.part(6) == "last");
+  CHECK(index.part(7) == "");
+  CHECK(index.find() == 1);
+  CHECK(index.find(4) == 4);
+  CHECK(index.find(10) == std::string_view::npos);
+  CHECK(index.count(0, text.size()) == 6);
+  CHECK(index.count(3, 7) == 3);
+  CHECK(index.count(7, 3) == 0);
+  CHECK(index.split() == std::vector<std::string_view>{"a", "b", "", "c", "", "", "last"});
+  CHECK(index.split(false) == std::vector<std::string_view>{"a", "b", "c", "last"});
+
+  delimiter_index single{text, ","};
+  CHECK(single.split() == split(text, ","));
+  delimiter_index none{text, ""};
+  CHECK(none.count() == 0);
+  CHECK(none.split() == std::vector<std::string_view>{text});
+
+  // Same parts as split at every simd level, also for sets only the scalar code handles
+  std::string long_text;
+  for (int i = 0; i < 500; i++)
+    long_text += "field" + std::string(static_cast<std::size_t>(i % 70), 'x') + ",;|\t"[i % 4];
+  const auto initial = active_simd_level();
+  for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2,
+      simd_level::avx512bw}) {
+    if (level > detected_simd_level())
+      break;
+    set_simd_level(level);
+    auto level_value = static_cast<int>(level);
+    CAPTURE(level_value);
+    CHECK(delimiter_index{long_text, ","}.split() == split(long_text, ","));
+    std::string replaced = long_text;
+    for (auto& c : replaced)
+      c = c == ';' || c == '|' || c == '\t' ? ',' : c;
+    CHECK(delimiter_index{long_text, ",;|\t"}.split() == split(replaced, ","));
+    CHECK(delimiter_index{long_text, ",;|\t<>[]{}"}.count() ==
+        delimiter_index{long_text, ",;|\t"}.count());
+  }
+  set_simd_level(initial);
+}
+
+
+TEST_CASE("split_small") {
+  using namespace nonstd::string_utils;
+
+  auto host = split_small<4>("example.com:8080", ":");
+  CHECK(host.size() == 2);
+  CHECK(host.is_inline());
+  CHECK(host[0] == "example.com");
+  CHECK(host.back() == "8080");
+
+  auto many = split_small<4>("a,b,,c,d,e", ",");
+  CHECK(!many.is_inline());
+  CHECK(std::vector<std::string_view>(many.begin(), many.end()) == split("a,b,,c,d,e", ","));
+  auto searched = split_small<2>("--a----b--c", searcher{"--"}, false);
+  CHECK(std::vector<std::string_view>(searched.begin(), searched.end()) ==
+      std::vector<std::string_view>{"a", "b", "c"});
+
+  SUBCASE("copy and move") {
+    auto copy = many;
+    CHECK(copy == many);
+    CHECK(copy.data() != many.data());
+    auto inline_copy = host;
+    CHECK(inline_copy == host);
+    CHECK(inline_copy.is_inline());
+    auto moved = std::move(many);
+    CHECK(moved == copy);
+    CHECK(many.empty());
+    CHECK(many.is_inline());
+    auto moved_inline = std::move(inline_copy);
+    CHECK(moved_inline == host);
+    CHECK(moved_inline.is_inline());
+    moved = host;
+    CHECK(moved == host);
+    moved = std::move(copy);
+    CHECK(moved.size() == 6);
+    CHECK(moved != host);
+  }
+
+  SUBCASE("growth") {
+    small_vector<int, 2> v;
+    for (int i = 0; i < 100; i++)
+      v.push_back(i);
+    v.push_back(v[0]);
+    CHECK(v.size() == 101);
+    CHECK(v.back() == 0);
+    CHECK(v[99] == 99);
+    auto capacity = v.capacity();
+    v.clear();
+    CHECK(v.empty());
+    CHECK(v.capacity() == capacity);
+    v.emplace_back(7);
+    CHECK(v.front() == 7);
+  }
+
+  for (std::size_t n = 0; n < 40; n++) {
+    std::string text(n, ',');
+    auto parts = split_small<8>(text, ",");
+    CHECK(parts.size() == n + 1);
+    CHECK(parts.is_inline() == (n < 8));
+  }
+}
+
+
+TEST_CASE("string_column") {
+  using namespace nonstd::string_utils;
+
+  auto column = split_into_column("a,bb,,ccc", ",");
+  CHECK(column.size() == 4);
+  CHECK(column[0] == "a");
+  CHECK(column[1] == "bb");
+  CHECK(column[2] == "");
+  CHECK(column.back() == "ccc");
+  CHECK(column.chars() == "abbccc");
+  CHECK(column.offsets() == std::vector<std::uint32_t>{0, 1, 3, 3, 6});
+  CHECK(std::vector<std::string_view>(column.begin(), column.end()) == split("a,bb,,ccc", ","));
+  CHECK(column.end() - column.begin() == 4);
+  CHECK(column.begin()[3] == "ccc");
+  CHECK(*(column.end() - 2) == "");
+  CHECK(std::find(column.begin(), column.end(), "bb") - column.begin() == 1);
+
+  split_into_column("--x----y--", "--", column, false);
+  CHECK(std::vector<std::string_view>(column.begin(), column.end()) ==
+      std::vector<std::string_view>{"x", "y"});
+  static const searcher token{"--"};
+  CHECK(split_into_column("--x----y--", token).size() == 5);
+
+  split_into_column("", ",", column);
+  CHECK(column.size() == 1);
+  CHECK(column.front().empty());
+  column.clear();
+  CHECK(column.empty());
+  CHECK(column.begin() == column.end());
+  column.push_back("pushed");
+  CHECK(column[0] == "pushed");
+
+  // Same parts as split, also when the column is reused
+  std::string text;
+  for (int i = 0; i < 300; i++) {
+    text += std::string(static_cast<std::size_t>(i % 17), static_cast<char>('a' + i % 26));
+    text += ';';
+    split_into_column(text, ";", column, i % 2 == 0);
+    CHECK(std::vector<std::string_view>(column.begin(), column.end()) ==
+        split(text, ";", i % 2 == 0));
+  }
+}
+
+
+// Allocator counting the bytes it hands out, copies share the count
+template <typename T> struct counting_allocator
+{
+  using value_type = T;
+
+  explicit counting_allocator(std::size_t* bytes) : bytes{bytes} {}
+  template <typename U> counting_allocator(const counting_allocator<U>& other)
+      : bytes{other.bytes} {}
+
+  T* allocate(std::size_t n)
+  {
+    *bytes += n * sizeof(T);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+  template <typename U> bool operator==(const counting_allocator<U>& other) const
+  {
+    return bytes == other.bytes;
+  }
+  template <typename U> bool operator!=(const counting_allocator<U>& other) const
+  {
+    return bytes != other.bytes;
+  }
+
+  std::size_t* bytes;
+};
+
+
+TEST_CASE("allocator overloads") {
+  using namespace nonstd::string_utils;
+
+  std::size_t bytes = 0;
+  counting_allocator<char> alloc{&bytes};
+  const std::string_view text = "a part that does not fit into SSO,b,,c";
+  static const searcher comma{","};
+
+  auto parts = split_copy(text, ",", alloc);
+  CHECK(parts.size() == 4);
+  CHECK(parts[0] == "a part that does not fit into SSO");
+  CHECK(parts[3] == "c");
+  CHECK(parts.get_allocator() == alloc);
+  CHECK(parts[0].get_allocator() == alloc);
+  CHECK(bytes > 0);
+  CHECK(split_copy(text, comma, alloc, false).size() == 3);
+  CHECK(split_copy(text, ",", false).size() == 3);
+  CHECK(split_chars_copy("123456", 2, 1, alloc).size() == 2);
+
+  bytes = 0;
+  auto long_text = std::string{"<tag>"} + std::string(40, 'x') + "</tag>";
+  CHECK(between_copy(long_text, "<tag>", "</tag>", alloc) ==
+      std::string_view{long_text}.substr(5, 40));
+  CHECK(bytes > 40);
+  CHECK(rbetween_copy("a[b]c[d]", "]", "[", alloc) == "d");
+  CHECK(between_copy("(a)(b)", "(", ")", alloc, true) == "a)(b");
+  CHECK(before_first_copy(text, comma, alloc) == "a part that does not fit into SSO");
+  CHECK(before_last_copy(text, ",", alloc) == "a part that does not fit into SSO,b,");
+  CHECK(after_first_copy(text, ",", alloc) == "b,,c");
+  CHECK(after_last_copy(text, comma, alloc) == "c");
+  CHECK(split_first_copy("k=v=w", "=", alloc) == std::make_tuple("k", "v=w"));
+  CHECK(split_last_copy("k=v=w", "=", alloc) == std::make_tuple("k=v", "w"));
+
+  bytes = 0;
+  auto replaced = replace(long_text, "x", "yy", alloc);
+  CHECK(std::string_view{replaced} == replace(long_text, "x", "yy"));
+  CHECK(replaced.get_allocator() == alloc);
+  CHECK(bytes >= replaced.size());
+  CHECK(std::string_view{replace(long_text, searcher{"tag"}, "TAG", alloc)} ==
+      replace(long_text, "tag", "TAG"));
+  CHECK(std::string_view{ascii::as_upper(long_text, alloc)} == ascii::as_upper(long_text));
+  CHECK(ascii::as_lower("ABC", alloc) == "abc");
+  char buffer[4];
+  CHECK(ascii::as_lower("ABC", buffer) == "abc");
+
+#if __has_include(<memory_resource>)
+  // Everything from a buffer on the stack
+  char storage[4096];
+  std::pmr::monotonic_buffer_resource resource{storage, sizeof(storage),
+      std::pmr::null_memory_resource()};
+  std::pmr::polymorphic_allocator<char> pmr_alloc{&resource};
+  std::pmr::vector<std::pmr::string> pmr_parts = split_copy(text, ",", pmr_alloc);
+  CHECK(pmr_parts[0] == "a part that does not fit into SSO");
+  CHECK(pmr_parts[0].get_allocator().resource() == &resource);
+  std::pmr::string upper = ascii::as_upper(text, pmr_alloc);
+  CHECK(upper.get_allocator().resource() == &resource);
+  CHECK(upper.substr(0, 6) == "A PART");
+  std::pmr::string lowered = replace(upper, "PART", "piece", pmr_alloc);
+  CHECK(after_first_copy(lowered, "A ", pmr_alloc).substr(0, 5) == "piece");
+#endif
+}
+
+
+TEST_CASE("split_copy into an arena") {
+  using namespace nonstd::string_utils;
+
+  string_arena arena{16};
+  std::vector<std::string_view> parts;
+  {
+    auto text = std::string{"a long part that does not fit into SSO,b,,c"};
+    parts = split_copy(text, ",", arena);
+    CHECK(arena.size() == 40);
+    text.assign(text.size(), '#');
+  }
+  CHECK(parts == std::vector<std::string_view>{"a long part that does not fit into SSO", "b", "",
+      "c"});
+  // All parts of one call are in one block
+  CHECK(parts[1].data() == parts[0].data() + parts[0].size());
+  CHECK(parts[3].data() == parts[1].data() + 1);
+
+  static const searcher token{"--"};
+  auto more = split_copy("--x----y--", token, arena, false);
+  CHECK(more == std::vector<std::string_view>{"x", "y"});
+  CHECK(parts[0] == "a long part that does not fit into SSO");
+  CHECK(arena.size() == 42);
+
+  std::vector<std::string_view> reused;
+  split_copy("1;2;3", ";", arena, reused);
+  auto capacity = reused.capacity();
+  split_copy("4;5", ";", arena, reused);
+  CHECK(reused == std::vector<std::string_view>{"4", "5"});
+  CHECK(reused.capacity() == capacity);
+
+  arena.clear();
+  CHECK(arena.size() == 0);
+  auto kept = arena.copy("reused block");
+  CHECK(kept == "reused block");
+  CHECK(arena.size() == 12);
+  CHECK(arena.copy("").empty());
+
+  // Many small calls share blocks
+  string_arena small;
+  std::vector<std::string_view> all;
+  for (int i = 0; i < 1000; i++) {
+    auto record = std::to_string(i) + ",x" + std::to_string(i * 7);
+    for (auto part : split_copy(record, ",", small))
+      all.push_back(part);
+  }
+  CHECK(all.size() == 2000);
+  CHECK(all[1998] == "999");
+  CHECK(all[1999] == "x6993");
+
+  // A moved from arena does not hand out memory of the one it was moved into
+  string_arena from{64};
+  auto x = from.copy("HELLO");
+  string_arena to = std::move(from);
+  auto w = from.copy("WORLD");
+  CHECK((w.data() < x.data() || w.data() >= x.data() + 64));
+  CHECK(from.size() == 5);
+  CHECK(to.size() == 5);
+  CHECK(to.copy("AGAIN").data() == x.data() + 5);
+  CHECK(x == "HELLO");
+  CHECK(w == "WORLD");
+  from = std::move(to);
+  CHECK(to.size() == 0);
+  to.clear();
+  CHECK(to.copy("NEW").data() != x.data() + 10);
+  CHECK(from.size() == 10);
+}
+
+
+TEST_CASE("split into existing containers") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("views") {
+    std::vector<std::string_view> v;
+    split("a,b,c", ",", v);
+    CHECK(v == std::vector<std::string_view>{"a", "b", "c"});
+    auto capacity = v.capacity();
+    auto data = v.data();
+    split("x123y", "123", v);
+    CHECK(v == std::vector<std::string_view>{"x", "y"});
+    CHECK(v.capacity() == capacity);
+    CHECK(v.data() == data);
+    split(",,d,", ",", v, false);
+    CHECK(v == std::vector<std::string_view>{"d"});
+    split("", ",", v);
+    CHECK(v.size() == 1);
+    CHECK(v[0].empty());
+  }
+
+  SUBCASE("copies") {
+    std::vector<std::string> v;
+    split_copy("a long part that does not fit into SSO,b", ",", v);
+    CHECK(v == std::vector<std::string>{"a long part that does not fit into SSO", "b"});
+    auto data = v[0].data();
+    split_copy("another long part past the SSO,c,d", ",", v);
+    CHECK(v == std::vector<std::string>{"another long part past the SSO", "c", "d"});
+    CHECK(v[0].data() == data);
+    split_copy("e", ",", v);
+    CHECK(v == std::vector<std::string>{"e"});
+  }
+
+  SUBCASE("output iterator") {
+    std::string_view parts[4];
+    auto end = split_to("a--b----c", "--", std::begin(parts), false);
+    CHECK(end - std::begin(parts) == 3);
+    CHECK(parts[0] == "a");
+    CHECK(parts[1] == "b");
+    CHECK(parts[2] == "c");
+
+    std::vector<std::string_view> v;
+    split_to("1,,2", ",", std::back_inserter(v));
+    CHECK(v == std::vector<std::string_view>{"1", "", "2"});
+  }
+}
+
+
+TEST_CASE("split_for_each") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("all parts") {
+    std::vector<std::string_view> v;
+    CHECK(split_for_each(",a,,b", ",", [&](std::string_view part) { v.push_back(part); }));
+    CHECK(v == split(",a,,b", ","));
+    v.clear();
+    CHECK(split_for_each("a123b123", "123", [&](std::string_view part) { v.push_back(part); },
+        false));
+    CHECK(v == split("a123b123", "123", false));
+  }
+
+  SUBCASE("stop early") {
+    std::vector<std::string_view> v;
+    CHECK(split_for_each("a,b,c,d", ",", [&](std::string_view part) {
+      v.push_back(part);
+      return part != "b";
+    }) == false);
+    CHECK(v == std::vector<std::string_view>{"a", "b"});
+  }
+
+  SUBCASE("split_chars_for_each") {
+    std::vector<std::string_view> v;
+    CHECK(split_chars_for_each("abc,def,ghi,jkl,mno,p", 3, 1,
+        [&](std::string_view part) { v.push_back(part); }));
+    CHECK(v == split_chars("abc,def,ghi,jkl,mno,p", 3, 1));
+    v.clear();
+    CHECK(split_chars_for_each("abcdef", 2, 0, [&](std::string_view part) {
+      v.push_back(part);
+      return false;
+    }) == false);
+    CHECK(v == std::vector<std::string_view>{"ab"});
+    CHECK(split_chars_for_each("abc", 0, 0, [](std::string_view) { return false; }));
+  }
+}
+
+
+TEST_CASE("split_view") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("same parts as split") {
+    for (const char* s : {"a,b,c", ",bb,cc", "aaa,b,", "", ",", ",,", "abc"}) {
+      for (bool keep_empty_parts : {true, false}) {
+        auto v = split(s, ",", keep_empty_parts);
+        auto sv = split_view{s, ",", keep_empty_parts};
+        CHECK(std::vector<std::string_view>(sv.begin(), sv.end()) == v);
+      }
+    }
+    for (const char* s : {"a123b123c", "123bb123cc", "aaa123b123", "123", "123123"}) {
+      for (bool keep_empty_parts : {true, false}) {
+        auto v = split(s, "123", keep_empty_parts);
+        auto sv = split_view{s, "123", keep_empty_parts};
+        CHECK(std::vector<std::string_view>(sv.begin(), sv.end()) == v);
+      }
+    }
+  }
+
+  SUBCASE("stop early") {
+    std::string_view first;
+    int count = 0;
+    for (auto part : split_view{"key=value=more", "="}) {
+      first = part;
+      if (++count == 1)
+        break;
+    }
+    CHECK(first == "key");
+    CHECK(count == 1);
+  }
+
+  SUBCASE("empty token") {
+    auto sv = split_view{"abc", ""};
+    auto it = sv.begin();
+    CHECK(*it == "abc");
+    CHECK(++it == sv.end());
+  }
+}
+
+
 TEST_CASE("split first/last") {
   using namespace nonstd::string_utils;
 
@@ -449,9 +1174,447 @@ TEST_CASE("replace") {
     auto s = std::string{"test with test ok, test123 test"};
     CHECK(detail::replace_inplace(s, "test", "rofl") == "rofl with rofl ok, rofl123 rofl");
   }
+
+  SUBCASE("many matches") {
+    // Sparse matches first so the result is sized too small, then dense ones
+    std::string s;
+    std::string expected;
+    for (int i = 0; i < 100; i++) {
+      s += std::string(999, '.') + "x";
+      expected += std::string(999, '.') + "<xyz>";
+    }
+    s += std::string(10000, 'x');
+    for (int i = 0; i < 10000; i++)
+      expected += "<xyz>";
+    CHECK(replace(s, "x", "<xyz>") == expected);
+    CHECK(replace(expected, "<xyz>", "x") == s);
+    CHECK(replace(s, "x", "") == std::string(99900, '.'));
+  }
+}
+
+
+TEST_CASE("replace_in") {
+  using namespace nonstd::string_utils;
+
+  auto check = [](std::string s, std::string_view search, std::string_view replacement) {
+    auto expected = replace(s, search, replacement);
+    auto copy = s;
+    replace_in(s, search, replacement);
+    replace_in(copy, searcher{search}, replacement);
+    CHECK(s == expected);
+    CHECK(copy == expected);
+  };
+
+  SUBCASE("equal size") {
+    std::string s = "test with test ok, test123 test";
+    const auto data = s.data();
+    CHECK(replace_in(s, "test", "rofl") == 4);
+    CHECK(s == "rofl with rofl ok, rofl123 rofl");
+    CHECK(s.data() == data);
+  }
+
+  SUBCASE("shorter") {
+    std::string s = "hello beautiful world";
+    CHECK(replace_in(s, "beautiful", "big") == 1);
+    CHECK(s == "hello big world");
+    CHECK(replace_in(s, "o", "") == 2);
+    CHECK(s == "hell big wrld");
+    check("aaaaa", "aa", "b");
+    check("abcabcabc", "abc", "");
+  }
+
+  SUBCASE("longer") {
+    std::string s = "man fears time";
+    CHECK(replace_in(s, "time", "the pyramids") == 1);
+    CHECK(s == "man fears the pyramids");
+    check("aaaaa", "aa", "aaa");
+    check("abab", "ab", "abab");
+    check("xyz", "x", "<x>");
+    check("xyz", "z", "<z>");
+  }
+
+  SUBCASE("no matches") {
+    std::string s = "hello";
+    CHECK(replace_in(s, "x", "yy") == 0);
+    CHECK(replace_in(s, "", "yy") == 0);
+    CHECK(replace_in(s, "hello!", "") == 0);
+    CHECK(s == "hello");
+  }
+
+  SUBCASE("many matches") {
+    std::string s;
+    for (int i = 0; i < 1000; i++)
+      s += i % 3 == 0 ? "x" : "ab";
+    check(s, "x", "<xyz>");
+    check(s, "ab", "");
+    check(s, "abab", "c");
+    check(s, "xab", "xabxab");
+  }
+}
+
+
+TEST_CASE("replace_all") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("escaping") {
+    auto html = replace_all("<a href=\"x\">Tom & Jerry</a>",
+        {{"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}, {"\"", "&quot;"}});
+    CHECK(html == "&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&lt;/a&gt;");
+    CHECK(replace_all("", {{"a", "b"}}) == "");
+    CHECK(replace_all("abc", {}) == "abc");
+    CHECK(replace_all("abc", {{"x", "y"}}) == "abc");
+    CHECK(replace_all("abc", {{"abc", ""}}) == "");
+  }
+
+  SUBCASE("no chaining") {
+    CHECK(replace_all("man fears time", {{"time", "the pyramids"}, {"man", "time"}}) ==
+        "time fears the pyramids");
+    CHECK(replace_all("ab", {{"a", "b"}, {"b", "a"}}) == "ba");
+  }
+
+  SUBCASE("leftmost longest") {
+    CHECK(replace_all("abcd", {{"bcd", "1"}, {"abc", "2"}}) == "2d");
+    CHECK(replace_all("abcd", {{"ab", "1"}, {"abcd", "2"}}) == "2");
+    CHECK(replace_all("abcd", {{"abcd", "1"}, {"ab", "2"}}) == "1");
+    CHECK(replace_all("abcx", {{"abcd", "1"}, {"bc", "2"}}) == "a2x");
+    CHECK(replace_all("aaaa", {{"aa", "b"}}) == "bb");
+    CHECK(replace_all("aaa", {{"aa", "b"}, {"a", "c"}}) == "bc");
+    CHECK(replace_all("she sells", {{"he", "1"}, {"she", "2"}, {"s", "3"}}) == "2 3ell3");
+  }
+
+  SUBCASE("duplicate and empty tokens") {
+    CHECK(replace_all("abc", {{"b", "1"}, {"b", "2"}}) == "a1c");
+    CHECK(replace_all("abc", {{"", "x"}, {"c", "3"}}) == "ab3");
+    CHECK(replace_all("abc", {{"", "x"}}) == "abc");
+  }
+
+  SUBCASE("reused replacer") {
+    std::vector<std::pair<std::string, std::string>> tokens = {{"{{name}}", "World"},
+        {"{{greeting}}", "Hello"}};
+    const multi_replacer replacer{tokens};
+    CHECK(replacer.replace("{{greeting}}, {{name}}!") == "Hello, World!");
+    CHECK(replace_all("{{name}}{{name}} {{nam}}", replacer) == "WorldWorld {{nam}}");
+  }
+
+  SUBCASE("more matches than a batch") {
+    std::string text;
+    for (int i = 0; i < 300; i++)
+      text += i % 3 == 0 ? "&amp;x" : i % 3 == 1 ? "&lt;" : "y";
+    auto unescaped = replace_all(text, {{"&amp;", "&"}, {"&lt;", "<"}});
+    CHECK(unescaped == replace(replace(text, "&amp;", "&"), "&lt;", "<"));
+    CHECK(replace_all(unescaped, {{"&", "&amp;"}, {"<", "&lt;"}}) == text);
+    CHECK(replace_all(text, {{"&amp;", "+"}, {"y", "yy"}}) ==
+        replace(replace(text, "&amp;", "+"), "y", "yy"));
+  }
+
+  SUBCASE("same result at every simd level") {
+    std::string text;
+    for (int i = 0; i < 500; i++)
+      text += "<p class=\"x\">a & b</p>\n"[i % 23];
+    const multi_replacer replacer{{"&", "&amp;"}, {"<", "&lt;"}, {"</p>", "</P>"},
+        {"p", "P"}, {"class=", ""}};
+    std::string expected;
+    for (std::size_t i = 0; i < text.size(); i++) {
+      if (text.compare(i, 4, "</p>") == 0)
+        expected += "</P>", i += 3;
+      else if (text.compare(i, 6, "class=") == 0)
+        i += 5;
+      else if (text[i] == '&')
+        expected += "&amp;";
+      else if (text[i] == '<')
+        expected += "&lt;";
+      else if (text[i] == 'p')
+        expected += 'P';
+      else
+        expected += text[i];
+    }
+
+    const auto initial = active_simd_level();
+    for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2,
+        simd_level::avx512bw}) {
+      if (level > detected_simd_level())
+        break;
+      set_simd_level(level);
+      auto level_value = static_cast<int>(level);
+      CAPTURE(level_value);
+      CHECK(replacer.replace(text) == expected);
+    }
+    set_simd_level(initial);
+  }
+}
+
+
+TEST_CASE("stream_replacer") {
+  using namespace nonstd::string_utils;
+
+  auto chunked = [](stream_replacer& replacer, std::string_view sv, std::size_t chunk_size) {
+    std::string out;
+    for (std::size_t i = 0; i < sv.size(); i += chunk_size)
+      replacer.feed(sv.substr(i, chunk_size), out);
+    replacer.finish(out);
+    return out;
+  };
+
+  SUBCASE("matches across chunks") {
+    const std::string_view text = "hello beautiful world, beautiful beautiful";
+    stream_replacer replacer{"beautiful", "big"};
+    for (std::size_t chunk_size = 1; chunk_size <= text.size(); chunk_size++) {
+      CAPTURE(chunk_size);
+      CHECK(chunked(replacer, text, chunk_size) == "hello big world, big big");
+    }
+  }
+
+  SUBCASE("overlapping candidates") {
+    stream_replacer replacer{"aab", "X"};
+    for (std::size_t chunk_size = 1; chunk_size <= 8; chunk_size++)
+      CHECK(chunked(replacer, "aaabaaaabaa", chunk_size) == "aXaaXaa");
+  }
+
+  SUBCASE("empty chunks and tokens") {
+    stream_replacer replacer{"ab", "c"};
+    std::string out;
+    replacer.feed("", out);
+    replacer.feed("a", out);
+    replacer.feed("", out);
+    replacer.feed("b", out);
+    replacer.feed("a", out);
+    replacer.finish(out);
+    CHECK(out == "ca");
+
+    stream_replacer unchanged{"", "x"};
+    CHECK(chunked(unchanged, "abc", 2) == "abc");
+  }
+
+  SUBCASE("callback") {
+    stream_replacer replacer{"\r\n", "\n"};
+    std::vector<std::string> parts;
+    auto collect = [&](std::string_view sv) { parts.emplace_back(sv); };
+    replacer.feed("one\r", collect);
+    replacer.feed("\ntwo\r\nthree\r", collect);
+    replacer.finish(collect);
+    CHECK(parts == std::vector<std::string>{"one", "\n", "two", "\n", "three", "\r"});
+  }
+}
+
+
+TEST_CASE("tokenizer") {
+  using namespace nonstd::string_utils;
+
+  auto chunked = [](tokenizer& t, std::string_view sv, std::size_t chunk_size) {
+    std::vector<std::string> parts;
+    auto collect = [&](std::string_view part) { parts.emplace_back(part); };
+    for (std::size_t i = 0; i < sv.size(); i += chunk_size)
+      t.feed(sv.substr(i, chunk_size), collect);
+    t.finish(collect);
+    return parts;
+  };
+
+  SUBCASE("same parts as split") {
+    const std::string_view text = ",one,, two::three,four::,:five::";
+    for (auto token : {",", "::", ", t"}) {
+      for (bool keep_empty : {true, false}) {
+        tokenizer t{token, keep_empty};
+        for (std::size_t chunk_size = 1; chunk_size <= text.size(); chunk_size++) {
+          CAPTURE(token);
+          CAPTURE(chunk_size);
+          CHECK(chunked(t, text, chunk_size) == split_copy(text, token, keep_empty));
+        }
+      }
+    }
+  }
+
+  SUBCASE("parts within a chunk are not copied") {
+    tokenizer t{"\n"};
+    std::string_view chunk = "first\nsecond\nthi";
+    std::vector<std::string_view> parts;
+    t.feed(chunk, [&](std::string_view part) { parts.push_back(part); });
+    REQUIRE(parts.size() == 2);
+    CHECK(parts[0].data() == chunk.data());
+    CHECK(parts[1].data() == chunk.data() + 6);
+
+    std::vector<std::string> rest;
+    t.feed("rd\nfourth", [&](std::string_view part) { rest.emplace_back(part); });
+    t.finish([&](std::string_view part) { rest.emplace_back(part); });
+    CHECK(rest == std::vector<std::string>{"third", "fourth"});
+  }
+
+  SUBCASE("no input") {
+    tokenizer keep{","};
+    CHECK(chunked(keep, "", 1) == std::vector<std::string>{""});
+    tokenizer skip{",", false};
+    CHECK(chunked(skip, "", 1).empty());
+  }
+}
+
+
+TEST_CASE("simd levels") {
+  using namespace nonstd::string_utils;
+  const auto initial = active_simd_level();
+
+  set_simd_level(simd_level::avx512bw);
+  CHECK(active_simd_level() == detected_simd_level());
+
+  // Every byte value and lengths past the widest block, matches at all block offsets
+  std::string text;
+  for (int i = 0; i < 300; i++)
+    text += static_cast<char>(i % 7 == 0 ? 'x' : (i * 37) % 256);
+
+  for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512bw}) {
+    if (level > detected_simd_level())
+      break;
+    set_simd_level(level);
+    auto level_value = static_cast<int>(level);
+    CAPTURE(level_value);
+
+    for (std::size_t n = 0; n <= text.size(); n += 13) {
+      auto sv = std::string_view{text}.substr(0, n);
+      for (auto token : {std::string_view{"x"}, std::string_view{"xN"},
+          std::string_view{text}.substr(99, 2), std::string_view{text}.substr(150, 40)}) {
+        for (std::size_t pos = 0; pos < n; pos += 29)
+          CHECK(detail::find(sv, token, pos) == sv.find(token, pos));
+      }
+      CHECK(starts_with(text, sv) == !sv.empty());
+      CHECK(ends_with(text, std::string_view{text}.substr(text.size() - n)) == (n > 0));
+
+      auto upper = std::string{sv};
+      auto lower = std::string{sv};
+      for (auto& c : upper)
+        c = c >= 'a' && c <= 'z' ? static_cast<char>(c - 32) : c;
+      for (auto& c : lower)
+        c = c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c;
+      CHECK(ascii::as_upper(sv) == upper);
+      CHECK(ascii::as_lower(sv) == lower);
+    }
+    CHECK(starts_with(text, text + "x") == false);
+    CHECK(ends_with(text, "y" + text.substr(1)) == false);
+    CHECK(split(text, 'x') == detail::split_keep_empty<std::string_view>(text, "x"));
+  }
+
+  set_simd_level(initial);
+}
+
+
+TEST_CASE("searcher") {
+  using namespace nonstd::string_utils;
+  const auto initial = active_simd_level();
+
+  SUBCASE("same positions as find") {
+    // Tokens of every length, with repeated and rare bytes, found at all block offsets
+    std::string text;
+    for (int i = 0; i < 400; i++)
+      text += i % 11 == 0 ? 'Q' : "the lord said unto moses, aaaaaaab"[i % 34];
+    std::vector<std::string> tokens = {"", "a", "Q", "aa", "aaaab", "ab", "zz", "said unto",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaab", "moses, aaaaaaab"};
+    for (std::size_t len = 2; len <= 70; len += 3)
+      tokens.push_back(text.substr(len * 3, len));
+
+    for (auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2,
+        simd_level::avx512bw}) {
+      if (level > detected_simd_level())
+        break;
+      set_simd_level(level);
+      auto level_value = static_cast<int>(level);
+      CAPTURE(level_value);
+      for (const auto& token : tokens) {
+        searcher s{token};
+        CAPTURE(token);
+        for (std::size_t n = 0; n <= text.size(); n += 37) {
+          auto sv = std::string_view{text}.substr(0, n);
+          for (std::size_t pos = 0; pos <= n + 1; pos += 7)
+            CHECK(s.find(sv, pos) == sv.find(token, pos));
+          CHECK(s.rfind(sv) == sv.rfind(token));
+        }
+      }
+    }
+    set_simd_level(initial);
+  }
+
+  SUBCASE("overloads") {
+    const searcher comma{", "};
+    const std::string_view s = "a, b, , c";
+    CHECK(split(s, comma) == split(s, ", "));
+    CHECK(split(s, comma, false) == split(s, ", ", false));
+    CHECK(split_copy(s, comma) == split_copy(s, ", "));
+    CHECK(split(s, searcher{","}) == split(s, ","));
+
+    std::vector<std::string_view> parts;
+    split(s, comma, parts);
+    CHECK(parts == split(s, ", "));
+    std::vector<std::string> copies;
+    split_copy(s, comma, copies, false);
+    CHECK(copies == std::vector<std::string>{"a", "b", "c"});
+
+    std::size_t count = 0;
+    CHECK(split_for_each(s, comma, [&](std::string_view) { count++; }));
+    CHECK(count == 4);
+
+    CHECK(split_first(s, comma) == std::make_tuple("a", "b, , c"));
+    CHECK(split_last_copy(s, comma) == std::make_tuple("a, b, ", "c"));
+    CHECK(before_first(s, comma) == "a");
+    CHECK(before_last(s, comma) == "a, b, ");
+    CHECK(after_first(s, comma) == "b, , c");
+    CHECK(after_last_copy(s, comma) == "c");
+
+    auto line = std::string_view{"<AzureDiamond> hunter2 <b>"};
+    const searcher open{"<"};
+    const searcher close{">"};
+    CHECK(between(line, open, close) == "AzureDiamond");
+    CHECK(between(line, open, close, true) == "AzureDiamond> hunter2 <b");
+    CHECK(rbetween(line, close, open) == "b");
+
+    CHECK(replace("one two one", searcher{"one"}, "three") == "three two three");
+    CHECK(replace("one two one", searcher{"one"}, "six") == "six two six");
+  }
 }
 
 
+#ifdef NONSTD_STRING_UTILS_MMAP
+TEST_CASE("mapped_file") {
+  using namespace nonstd::string_utils;
+  const std::string path = "string_utils_mapped_file_test.txt";
+  {
+    std::ofstream fs{path, std::ios::binary};
+    fs << "first,line\r\nsecond,line\n";
+  }
+
+  SUBCASE("contents") {
+    mapped_file file{path};
+    REQUIRE(file.is_open());
+    CHECK(file.size() == 24);
+    CHECK(split(file, ",").size() == 3);
+    std::vector<std::string_view> v;
+    for (auto line : lines(file))
+      v.push_back(line);
+    CHECK(v == std::vector<std::string_view>{"first,line", "second,line"});
+
+    mapped_file populated{path, true, true};
+    CHECK(populated.view() == file.view());
+  }
+
+  SUBCASE("move") {
+    mapped_file file{path};
+    auto data = file.data();
+    mapped_file other{std::move(file)};
+    CHECK(other.data() == data);
+    CHECK(!file.is_open());
+    file = std::move(other);
+    CHECK(file.view().substr(0, 5) == "first");
+  }
+
+  SUBCASE("missing and empty files") {
+    CHECK(!mapped_file{"does/not/exist"}.is_open());
+    std::ofstream{path, std::ios::trunc};
+    mapped_file file{path};
+    CHECK(file.is_open());
+    CHECK(file.empty());
+    CHECK(file.view().empty());
+  }
+
+  std::remove(path.c_str());
+}
+#endif
+
+
 TEST_CASE("readme") {
   using namespace nonstd::string_utils;
   auto csv = std::string{"42,13.37,test"};
@@ -479,6 +1642,125 @@ TEST_CASE("split and split_chars cross check") {
 }
 
 
+TEST_CASE("fixed width parsing") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("valid") {
+    CHECK(as_uint32_fixed<1>("7") == 7);
+    CHECK(as_uint32_fixed<6>("116112") == 116112);
+    CHECK(as_uint32_fixed<6>("000042") == 42);
+    CHECK(as_uint32_fixed<8>("99999999") == 99999999);
+    CHECK(as_uint32_fixed<9>("123456789") == 123456789);
+    CHECK(as_uint32_fixed<10>("4294967295") == 4294967295u);
+    CHECK(as_uint64_fixed<16>("1234567890123456") == 1234567890123456u);
+    CHECK(as_uint64_fixed<19>("9999999999999999999") == 9999999999999999999u);
+    CHECK(as_uint64_fixed<20>("18446744073709551615") == 18446744073709551615u);
+  }
+
+  SUBCASE("invalid") {
+    CHECK(as_uint32_fixed<6>("11611") == 0);
+    CHECK(as_uint32_fixed<6>("1161122") == 0);
+    CHECK(as_uint32_fixed<10>("4294967296") == 0);
+    CHECK(as_uint64_fixed<20>("18446744073709551616") == 0);
+    CHECK(as_uint64_fixed<20>("99999999999999999999") == 0);
+    CHECK(as_uint32_fixed<3>("-12") == 0);
+    CHECK(as_uint32_fixed<3>("+12") == 0);
+
+    // Bytes right next to the digit range and ones that carry into the next byte
+    for (char c : {'/', ':', ' ', '\0', '\xFA', '\xFF'}) {
+      for (std::size_t i = 0; i < 16; i++) {
+        auto s = std::string(16, '1');
+        s[i] = c;
+        CHECK(as_uint64_fixed<16>(s) == 0);
+        if (i < 9)
+          CHECK(as_uint32_fixed<9>(std::string_view{s}.substr(0, 9)) == 0);
+      }
+    }
+  }
+}
+
+
+TEST_CASE("floating point parsing") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("values") {
+    CHECK(as_double("0") == 0.0);
+    CHECK(as_double("13.37") == 13.37);
+    CHECK(as_double("-13.37") == -13.37);
+    CHECK(as_double("+13.37") == 13.37);
+    CHECK(as_double(".5") == 0.5);
+    CHECK(as_double("5.") == 5.0);
+    CHECK(as_double("1e10") == 1e10);
+    CHECK(as_double("1E-10") == 1e-10);
+    CHECK(as_double("0.1") == 0.1);
+    CHECK(as_double("123456789012345678901234567890") == 123456789012345678901234567890.0);
+    CHECK(as_double("1.7976931348623157e308") == std::numeric_limits<double>::max());
+    CHECK(as_double("2.2250738585072014e-308") == std::numeric_limits<double>::min());
+    CHECK(as_double("4.9406564584124654e-324") == std::numeric_limits<double>::denorm_min());
+    CHECK(as_float("13.37") == 13.37f);
+    CHECK(as_float("3.4028235e38") == std::numeric_limits<float>::max());
+    CHECK(as_float("1.4e-45") == std::numeric_limits<float>::denorm_min());
+    CHECK(std::signbit(as_double("-0")));
+  }
+
+  SUBCASE("rounding") {
+    // Halfway between 1 and the next double, ties go to even unless any digit follows
+    CHECK(as_double("1.00000000000000011102230246251565404236316680908203125") == 1.0);
+    CHECK(as_double("1.000000000000000111022302462515654042363166809082031250000001") ==
+        std::nextafter(1.0, 2.0));
+    CHECK(as_double("9007199254740993") == 9007199254740992.0);
+    CHECK(as_double("9007199254740995") == 9007199254740996.0);
+    CHECK(as_double("2.4703282292062328e-324") == std::numeric_limits<double>::denorm_min());
+    CHECK(as_double("2.2250738585072011e-308") == 2.2250738585072011e-308);
+    CHECK(as_float("16777217") == 16777216.0f);
+  }
+
+  SUBCASE("special") {
+    CHECK(as_double("inf") == std::numeric_limits<double>::infinity());
+    CHECK(as_double("-Infinity") == -std::numeric_limits<double>::infinity());
+    CHECK(std::isnan(as_double("nan")));
+    CHECK(std::isnan(as_float("NaN(1)")));
+  }
+
+  SUBCASE("invalid and out of range") {
+    CHECK(as_double("") == 0.0);
+    CHECK(as_double(".") == 0.0);
+    CHECK(as_double("-") == 0.0);
+    CHECK(as_double("e5") == 0.0);
+    CHECK(as_double(" 1") == 0.0);
+    CHECK(as_double("1e400") == 0.0);
+    CHECK(as_double("1e-400") == 0.0);
+    CHECK(as_float("1e39") == 0.0f);
+    CHECK(as_double("1e") == 1.0);
+    CHECK(as_double("2.5x") == 2.5);
+  }
+
+#ifndef NONSTD_STRING_UTILS_CHARCONV_INTEGRAL_TYPES_ONLY
+  SUBCASE("same values as from_chars") {
+    const char* s = "0;-0;1;0.1;3.14159;1e308;1e309;1e-307;1e-320;1e-330;7e-46;1.17549435e-38;"
+        "0.30000000000000004;12345678901234567890123;0.000000000000000000000000000000123;"
+        "9007199254740992.5;4503599627370496.5;179769313486231580793728971405301e276;"
+        "2.4703282292062327e-324;0x10;1e+;inf;nan;infinit;1..2";
+    auto check = [&](auto type) {
+      using T = decltype(type);
+      split_for_each(s, ";", [&](std::string_view field) {
+        T expected = 7;
+        T value = 7;
+        auto r = std::from_chars(field.data(), field.data() + field.size(), expected);
+        auto result = detail::parse_float(field.data(), field.data() + field.size(), value);
+        CAPTURE(field);
+        CHECK(result.ptr == r.ptr);
+        CHECK(result.ec == r.ec);
+        CHECK(std::memcmp(&value, &expected, sizeof(T)) == 0);
+      });
+    };
+    check(float{});
+    check(double{});
+  }
+#endif
+}
+
+
 #ifdef NONSTD_STRING_UTILS_CHARCONV
 TEST_CASE("parse_number") {
   using namespace nonstd::string_utils;
@@ -502,4 +1784,91 @@ TEST_CASE("parse_number") {
   CHECK(as_int8("127") == 127);
   CHECK(as_int8("128") == 0);
 }
+
+
+TEST_CASE("parse_delimited") {
+  using namespace nonstd::string_utils;
+
+  SUBCASE("valid") {
+    std::vector<int> v;
+    auto result = parse_delimited<int>("42,-7,0,2147483647", ',', std::back_inserter(v));
+    CHECK(result);
+    CHECK(result.count == 4);
+    CHECK(v == std::vector<int>{42, -7, 0, 2147483647});
+
+    v.clear();
+    CHECK(parse_delimited<int>("", ',', std::back_inserter(v)));
+    CHECK(v.empty());
+
+    std::uint16_t a[3] = {};
+    CHECK(parse_delimited<std::uint16_t>("1|2|65535", '|', a).count == 3);
+    CHECK(a[2] == 65535);
+  }
+
+  SUBCASE("malformed") {
+    std::vector<int> v;
+    auto result = parse_delimited<int>("1,2x,3", ',', std::back_inserter(v));
+    CHECK(!result);
+    CHECK(result.count == 1);
+    CHECK(result.field == "2x");
+    CHECK(result.ec == std::errc::invalid_argument);
+    CHECK(v == std::vector<int>{1});
+
+    result = parse_delimited<std::uint8_t>("1,256", ',', std::back_inserter(v));
+    CHECK(result.field == "256");
+    CHECK(result.ec == std::errc::result_out_of_range);
+
+    result = parse_delimited<int>("1,,3", ',', std::back_inserter(v));
+    CHECK(result.count == 1);
+    CHECK(result.field.empty());
+
+    result = parse_delimited<int>("1,2,", ',', std::back_inserter(v));
+    CHECK(result.count == 2);
+    CHECK(result.ec == std::errc::invalid_argument);
+  }
+
+  SUBCASE("same values as from_chars") {
+    const char* s = "0,-0,127,-128,128,-129,255,256,32767,-32768,65535,2147483647,-2147483648,"
+        "2147483648,4294967295,4294967296,9223372036854775807,-9223372036854775808,"
+        "9223372036854775808,18446744073709551615,18446744073709551616,"
+        "00000000000000000000000042,-,1-,--1,+1, 1";
+    auto check = [&](auto type) {
+      using T = decltype(type);
+      split_for_each(s, ",", [&](std::string_view field) {
+        T expected{};
+        auto r = std::from_chars(field.data(), field.data() + field.size(), expected);
+        if (r.ec == std::errc{} && r.ptr != field.data() + field.size())
+          r.ec = std::errc::invalid_argument;
+        T value{};
+        auto result = parse_delimited<T>(field, ',', &value);
+        CAPTURE(field);
+        CHECK(result.ec == r.ec);
+        if (result)
+          CHECK(value == expected);
+      });
+    };
+    check(std::int8_t{});
+    check(std::uint8_t{});
+    check(std::int16_t{});
+    check(std::uint16_t{});
+    check(std::int32_t{});
+    check(std::uint32_t{});
+    check(std::int64_t{});
+    check(std::uint64_t{});
+  }
+
+  SUBCASE("floating point") {
+    std::vector<double> v;
+    auto result = parse_delimited<double>("1.5,-2e3,0.1,7", ',', std::back_inserter(v));
+    CHECK(result.count == 4);
+    CHECK(v == std::vector<double>{1.5, -2e3, 0.1, 7.0});
+
+    float f[2] = {};
+    result = parse_delimited<float>("0.25;1e39", ';', f);
+    CHECK(result.count == 1);
+    CHECK(f[0] == 0.25f);
+    CHECK(result.field == "1e39");
+    CHECK(result.ec == std::errc::result_out_of_range);
+  }
+}
 #endif